@@ -33,7 +33,10 @@ AppSettings *AppSettings::pSingelton = nullptr;
 
 const QString AppSettings::sSettingBuilderLastBrushIndex = "iBuilderLastBrushIndex";
 const QString AppSettings::sSettingBuilderLastLevel = "ubBuilderLastLevel";
+const QString AppSettings::sSettingGameAIBudget = "uiGameAIBudget";
+const QString AppSettings::sSettingGameAILookahead = "ubGameAILookahead";
 const QString AppSettings::sSettingGameBadLevelMode = "ubGameBadLevelMode";
+const QString AppSettings::sSettingGameCellWidgets = "bGameCellWidgets";
 const QString AppSettings::sSettingGameColours = "aGameColours";
 const QString AppSettings::sSettingGameCountAIs = "iGameCountAIs";
 const QString AppSettings::sSettingGameCountHumans = "iGameCountHumans";
@@ -47,7 +50,10 @@ const QString AppSettings::sSettingGameFakeBonuses = "bGameFakeBonuses";
 const QString AppSettings::sSettingGameLoadSetsStartLevel = "bGameLoadSetsStartLevel";
 const QString AppSettings::sSettingHistoryEnableClearAll = "bHistoryEnableClearAll";
 const QString AppSettings::sSettingGameOverOnLastDead = "bGameOverOnLastDead";
+const QString AppSettings::sSettingGameParallelAI = "bGameParallelAI";
+const QString AppSettings::sSettingGameRecordReplays = "bGameRecordReplays";
 const QString AppSettings::sSettingGameRelative = "aGameRelative";
+const QString AppSettings::sSettingGameReplayKeyframeTicks = "uiGameReplayKeyframeTicks0-65535";
 const QString AppSettings::sSettingGameSound = "bGameSound";
 const QString AppSettings::sSettingGameSpeed = "iGameSpeed0-3";
 const QString AppSettings::sSettingGameStartLevel = "ubGameStartLevel0-255";
@@ -62,13 +68,22 @@ const QString AppSettings::sSettingWindowMainSize = "windowMainSize";
 
 const quint8 AppSettings::ubSettingBuilderLastBrushIndexDefault = 0x0u;
 const quint8 AppSettings::ubSettingBuilderLastLevelDefault = 0x0u;
+// microseconds per tick WormAISearch may use, 0 for no limit
+const quint16 AppSettings::uiSettingGameAIBudgetDefault = 3000u;
+// bit n set: AI n uses WormAISearch instead of WormAI
+const quint8 AppSettings::ubSettingGameAILookaheadDefault = 0x0u;
 const quint8 AppSettings::ubSettingGameBadLevelModeDefault = 0x0u;
+// one widget per tile instead of SurfaceBoard
+const bool AppSettings::bSettingGameCellWidgetsDefault = false;
 const quint8 AppSettings::ubSettingGameCountAIsDefault = 0x4u;
 const quint8 AppSettings::ubSettingGameCountHumansDefault = 0x0u;
 const bool AppSettings::bSettingGameLimitLivesDefault = true;
 const QString AppSettings::sSettingGameNamesDefault = "Harry;Larry;Sarah;Trisha";
 const bool AppSettings::bSettingGameFakeBonusesDefault = false;
 const bool AppSettings::bSettingGameOverOnLastDeadDefault = false;
+const bool AppSettings::bSettingGameParallelAIDefault = true;
+const bool AppSettings::bSettingGameRecordReplaysDefault = false;
+const quint16 AppSettings::uiSettingGameReplayKeyframeTicksDefault = 0x1F4u;
 const bool AppSettings::bSettingGameSoundDefault = true;
 const qint8 AppSettings::iSettingGameSpeedDefault = 0u;
 const quint8 AppSettings::ubSettingGameStartLevelDefault = 0x1u;
@@ -104,7 +119,10 @@ AppSettings::AppSettings(QObject *parent) :
 
 	pS->setValue(sSettingBuilderLastBrushIndex, this->get(sSettingBuilderLastBrushIndex));
 	pS->setValue(sSettingBuilderLastLevel, this->get(sSettingBuilderLastLevel));
+	pS->setValue(sSettingGameAIBudget, this->get(sSettingGameAIBudget));
+	pS->setValue(sSettingGameAILookahead, this->get(sSettingGameAILookahead));
 	pS->setValue(sSettingGameBadLevelMode, this->get(sSettingGameBadLevelMode));
+	pS->setValue(sSettingGameCellWidgets, this->get(sSettingGameCellWidgets));
 
 	// make sure we have a valid list of colours
 	QList<QVariant> aList = pS->value(sSettingGameColours).toList();
@@ -136,6 +154,9 @@ AppSettings::AppSettings(QObject *parent) :
 	} // if not valid length list returned, make a new one
 
 	pS->setValue(sSettingGameOverOnLastDead, this->get(sSettingGameOverOnLastDead));
+	pS->setValue(sSettingGameParallelAI, this->get(sSettingGameParallelAI));
+	pS->setValue(sSettingGameRecordReplays, this->get(sSettingGameRecordReplays));
+	pS->setValue(sSettingGameReplayKeyframeTicks, this->get(sSettingGameReplayKeyframeTicks));
 
 	// make sure key-binding arrays exist
 	// Down
@@ -353,10 +374,22 @@ QVariant AppSettings::get(const QString sKey) const {
 
 		return this->pSettings->value(sKey, ubSettingBuilderLastLevelDefault);
 
+	} else if (sSettingGameAIBudget == sKey) {
+
+		return this->pSettings->value(sKey, uiSettingGameAIBudgetDefault);
+
+	} else if (sSettingGameAILookahead == sKey) {
+
+		return this->pSettings->value(sKey, ubSettingGameAILookaheadDefault);
+
 	} else if (sSettingGameBadLevelMode == sKey) {
 
 		return this->pSettings->value(sKey, ubSettingGameBadLevelModeDefault);
 
+	} else if (sSettingGameCellWidgets == sKey) {
+
+		return this->pSettings->value(sKey, bSettingGameCellWidgetsDefault);
+
 	} else if (sSettingGameColours == sKey) {
 
 		return this->pSettings->value(sKey);
@@ -381,6 +414,18 @@ QVariant AppSettings::get(const QString sKey) const {
 
 		return this->pSettings->value(sKey, bSettingGameOverOnLastDeadDefault);
 
+	} else if (sSettingGameParallelAI == sKey) {
+
+		return this->pSettings->value(sKey, bSettingGameParallelAIDefault);
+
+	} else if (sSettingGameRecordReplays == sKey) {
+
+		return this->pSettings->value(sKey, bSettingGameRecordReplaysDefault);
+
+	} else if (sSettingGameReplayKeyframeTicks == sKey) {
+
+		return this->pSettings->value(sKey, uiSettingGameReplayKeyframeTicksDefault);
+
 	} else if (sSettingGameRelative == sKey) {
 
 		return this->pSettings->value(sKey);
@@ -55,7 +55,10 @@ private:
 public:
 	static const QString sSettingBuilderLastBrushIndex;
 	static const QString sSettingBuilderLastLevel;
+	static const QString sSettingGameAIBudget;
+	static const QString sSettingGameAILookahead;
 	static const QString sSettingGameBadLevelMode;
+	static const QString sSettingGameCellWidgets;
 	static const QString sSettingGameColours;
 	static const QString sSettingGameCountAIs;
 	static const QString sSettingGameCountHumans;
@@ -67,7 +70,10 @@ public:
 	static const QString sSettingGameNames;
 	static const QString sSettingGameFakeBonuses;
 	static const QString sSettingGameOverOnLastDead;
+	static const QString sSettingGameParallelAI;
+	static const QString sSettingGameRecordReplays;
 	static const QString sSettingGameRelative;
+	static const QString sSettingGameReplayKeyframeTicks;
 	static const QString sSettingGameSound;
 	static const QString sSettingGameSpeed;
 	static const QString sSettingGameStartLevel;
@@ -85,13 +91,19 @@ public:
 
 	static const quint8 ubSettingBuilderLastBrushIndexDefault;
 	static const quint8 ubSettingBuilderLastLevelDefault;
+	static const quint16 uiSettingGameAIBudgetDefault;
+	static const quint8 ubSettingGameAILookaheadDefault;
 	static const quint8 ubSettingGameBadLevelModeDefault;
+	static const bool bSettingGameCellWidgetsDefault;
 	static const quint8 ubSettingGameCountAIsDefault;
 	static const quint8 ubSettingGameCountHumansDefault;
 	static const bool bSettingGameLimitLivesDefault;
 	static const QString sSettingGameNamesDefault;
 	static const bool bSettingGameFakeBonusesDefault;
 	static const bool bSettingGameOverOnLastDeadDefault;
+	static const bool bSettingGameParallelAIDefault;
+	static const bool bSettingGameRecordReplaysDefault;
+	static const quint16 uiSettingGameReplayKeyframeTicksDefault;
 	static const bool bSettingGameSoundDefault;
 	static const quint8 ubSettingGameStartLevelDefault;
 	static const quint8 ubSettingGameStartLivesDefault;
@@ -116,7 +128,8 @@ public:
 	QVariant get(const QString sKey) const;
 	QString getDataPath() const;
 	inline virtual QString getDataPathLevelFile(const quint8 ubLevel) {
-		static bool bFirst = true; if (bFirst) this->copyResources(":/Levels", this->sPathDataBase);
+		static bool bFirst = true;
+		if (bFirst) { bFirst = false; this->copyResources(":/Levels", this->sPathDataBase); }
 		return this->getDataPath() + "Level_" + QString::number(ubLevel); }
 
 	QSettings *getSettings() const;
@@ -0,0 +1,213 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Bitboard.h"
+
+#include <QtAlgorithms>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// rows of up to 255 cells, as many as a Map has
+#define SssS_Nibblers_Bitboard_Max_Words 4
+
+
+
+Bitboard::Bitboard(const int iColumns, const int iRows) :
+	iColumns(iColumns),
+	iRows(iRows),
+	iWords((iColumns + 63) >> 6),
+	uxMaskLast(~quint64(0u)) {
+
+	if (iColumns & 63) this->uxMaskLast = (quint64(1u) << (iColumns & 63)) - 1u;
+
+	this->auxBits.fill(0u, this->iWords * this->iRows);
+
+} // construct
+
+
+void Bitboard::assign(const Bitboard &oOther) {
+
+	// own storage, never shared with oOther
+	if (this->auxBits.length() != oOther.auxBits.length())
+		this->auxBits.fill(0u, oOther.auxBits.length());
+
+	this->iColumns = oOther.iColumns;
+	this->iRows = oOther.iRows;
+	this->iWords = oOther.iWords;
+	this->uxMaskLast = oOther.uxMaskLast;
+
+	quint64 *puxBits = this->auxBits.data();
+	const quint64 *puxOther = oOther.auxBits.constData();
+	for (int i = 0; i < this->auxBits.length(); ++i) puxBits[i] = puxOther[i];
+
+} // assign
+
+
+int Bitboard::count() const {
+
+	int iCount = 0;
+	const quint64 *puxBits = this->auxBits.constData();
+	for (int i = 0; i < this->auxBits.length(); ++i)
+		iCount += int(qPopulationCount(puxBits[i]));
+
+	return iCount;
+
+} // count
+
+
+void Bitboard::fill(const bool bSet) {
+
+	this->auxBits.fill(bSet ? ~quint64(0u) : 0u);
+
+	if (!bSet) return;
+
+	// keep padding clear, count() relies on it
+	for (int i = this->iWords - 1; i < this->auxBits.length(); i += this->iWords)
+		this->auxBits[i] &= this->uxMaskLast;
+
+} // fill
+
+
+void Bitboard::fillRow(quint64 *puxRow, const quint64 *puxMask) const {
+
+	const int iLast = this->iWords - 1;
+	const int iBitLast = (this->iColumns - 1) & 63;
+	quint64 auxEast[SssS_Nibblers_Bitboard_Max_Words];
+	quint64 auxWest[SssS_Nibblers_Bitboard_Max_Words];
+	quint64 uxNew;
+	bool bChanged = true;
+	int i;
+
+	while (bChanged) {
+
+		bChanged = false;
+
+		// every cell moves one column right and left
+		for (i = 0; i <= iLast; ++i) {
+
+			auxEast[i] = puxRow[i] << 1;
+			if (i) auxEast[i] |= puxRow[i - 1] >> 63;
+
+			auxWest[i] = puxRow[i] >> 1;
+			if (i < iLast) auxWest[i] |= puxRow[i + 1] << 63;
+
+		} // loop words
+
+		// wrap around
+		auxEast[0] |= (puxRow[iLast] >> iBitLast) & 1u;
+		auxWest[iLast] |= (puxRow[0] & 1u) << iBitLast;
+		auxEast[iLast] &= this->uxMaskLast;
+
+		for (i = 0; i <= iLast; ++i) {
+
+			uxNew = (puxRow[i] | auxEast[i] | auxWest[i]) & puxMask[i];
+			if (uxNew == puxRow[i]) continue;
+
+			puxRow[i] = uxNew;
+			bChanged = true;
+
+		} // loop words
+
+	} // loop until row stops growing
+
+} // fillRow
+
+
+int Bitboard::flood(const Bitboard &oPassable, const int iCell, const int iLimit) {
+
+	if ((this->iColumns != oPassable.iColumns) || (this->iRows != oPassable.iRows))
+		*this = Bitboard(oPassable.iColumns, oPassable.iRows);
+
+	this->fill(false);
+
+	const int iColumn = iCell % this->iColumns;
+	const int iRow = iCell / this->iColumns;
+	const int iCellNorth = (((iRow + this->iRows - 1) % this->iRows) * this->iColumns) + iColumn;
+	const int iCellSouth = (((iRow + 1) % this->iRows) * this->iColumns) + iColumn;
+	const int iCellWest = (iRow * this->iColumns)
+						  + ((iColumn + this->iColumns - 1) % this->iColumns);
+	const int iCellEast = (iRow * this->iColumns) + ((iColumn + 1) % this->iColumns);
+
+	if (oPassable.at(iCellNorth)) this->setAt(iCellNorth, true);
+	if (oPassable.at(iCellSouth)) this->setAt(iCellSouth, true);
+	if (oPassable.at(iCellWest)) this->setAt(iCellWest, true);
+	if (oPassable.at(iCellEast)) this->setAt(iCellEast, true);
+
+	int iCount = this->count();
+	if (iCount >= iLimit) return iCount;
+
+	quint64 *puxBits = this->auxBits.data();
+	const quint64 *puxPassable = oPassable.auxBits.constData();
+	const quint64 *puxAbove;
+	const quint64 *puxBelow;
+	quint64 *puxRow;
+	quint64 auxRow[SssS_Nibblers_Bitboard_Max_Words];
+	bool bChanged = true;
+	int iPass;
+	int iStep;
+	int i;
+	int j;
+
+	while (bChanged) {
+
+		bChanged = false;
+
+		// top to bottom then back up, so a pass carries cells across the
+		// whole board
+		for (iPass = 0; iPass < 2; ++iPass) {
+			for (iStep = 0; iStep < this->iRows; ++iStep) {
+
+				j = iPass ? this->iRows - 1 - iStep : iStep;
+
+				puxRow = puxBits + (j * this->iWords);
+				puxAbove = puxBits + (((j + this->iRows - 1) % this->iRows) * this->iWords);
+				puxBelow = puxBits + (((j + 1) % this->iRows) * this->iWords);
+
+				for (i = 0; i < this->iWords; ++i)
+					auxRow[i] = (puxRow[i] | puxAbove[i] | puxBelow[i])
+								& puxPassable[(j * this->iWords) + i];
+
+				this->fillRow(auxRow, puxPassable + (j * this->iWords));
+
+				for (i = 0; i < this->iWords; ++i) {
+
+					if (auxRow[i] == puxRow[i]) continue;
+
+					puxRow[i] = auxRow[i];
+					bChanged = true;
+
+				} // loop words
+
+			} // loop rows
+		} // loop down and up
+
+		iCount = this->count();
+		if (iCount >= iLimit) return iCount;
+
+	} // loop until nothing more is reached
+
+	return iCount;
+
+} // flood
+
+
+
+}	} // namespace SwissalpS::QtNibblers
@@ -0,0 +1,81 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <QVector>
+#include <QtGlobal>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// One bit per cell of a wrapping board, rows padded to whole 64-bit words.
+// flood() fills a row at a time with shifts, so it looks at 64 cells
+// per operation instead of one.
+class Bitboard {
+
+private:
+
+protected:
+	int iColumns;
+	int iRows;
+	// per row
+	int iWords;
+	// bits of last word of a row that are on the board
+	quint64 uxMaskLast;
+	QVector<quint64> auxBits;
+
+	// spreads puxRow left and right within puxMask, wrapping at the edges
+	void fillRow(quint64 *puxRow, const quint64 *puxMask) const;
+
+public:
+	explicit Bitboard(const int iColumns = 0, const int iRows = 0);
+
+	inline bool at(const int iCell) const {
+		return 0u != (this->auxBits.at(this->wordIndex(iCell))
+					  & (quint64(1u) << ((iCell % this->iColumns) & 63))); }
+
+	// copies without sharing, so later changes do not allocate
+	void assign(const Bitboard &oOther);
+	inline int cellCount() const { return this->iColumns * this->iRows; }
+	int count() const;
+	void fill(const bool bSet);
+
+	// sets all cells of oPassable that connect to a neighbour of iCell and
+	// clears the rest. Stops early once iLimit are set. Returns count set.
+	int flood(const Bitboard &oPassable, const int iCell, const int iLimit);
+	inline void setAt(const int iCell, const bool bSet) {
+		const quint64 uxBit = quint64(1u) << ((iCell % this->iColumns) & 63);
+		quint64 &uxWord = this->auxBits[this->wordIndex(iCell)];
+		uxWord = bSet ? (uxWord | uxBit) : (uxWord & ~uxBit); }
+
+	inline int wordIndex(const int iCell) const {
+		return ((iCell / this->iColumns) * this->iWords) + ((iCell % this->iColumns) >> 6); }
+
+}; // Bitboard
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // BITBOARD_H
@@ -18,8 +18,9 @@
 #ifndef BONUS_H
 #define BONUS_H
 
-#include <QObject>
-#include "SurfaceCell.h"
+#include <QPoint>
+#include <QVector>
+#include "MapGame.h"
 
 
 
@@ -27,50 +28,44 @@ namespace SwissalpS { namespace QtNibblers {
 
 
 
-class Bonus : public QObject {
-
-	Q_OBJECT
+// A bonus on the board. Game keeps them in a pool and times them out
+// with a wheel, see Game::expireBonuses(), so this is a plain record.
+class Bonus {
 
 private:
 
 protected:
-	bool bExpired;
 	bool bFake;
 	quint8 ubStateBase;
+	// Game's bonus clock at which it times out, 0 ticks never do
+	quint32 ulExpiry;
 	uint uiTicks;
 
-	QVector<SurfaceCell *> apCells;
-
-protected slots:
-	virtual void defreezeCells();
+	MapGame *pMap;
+	QVector<QPoint> aoPoints;
 
 public:
-	explicit Bonus(QVector<SurfaceCell *> apCells, const bool bFake,
-				   QObject *pParent = nullptr);
-	virtual ~Bonus();
-
-	virtual bool contains(const QPoint oPoint) const;
-	inline virtual bool contains(SurfaceCell *pCell) const { return this->apCells.contains(pCell); }
-	inline virtual QVector<SurfaceCell *> getCells() const { return this->apCells; }
-	inline virtual quint8 getStateBase() const { return this->ubStateBase; }
-	inline virtual bool hasExpired() const { return this->bExpired; }
-	inline virtual bool hasTimedOut() const { return 0 == this->uiTicks;}
-	inline virtual bool isFake() const { return this->bFake; }
-	virtual void setStateBase(const quint8 &ubState);
-	inline virtual void start(const uint uiTicks) { this->uiTicks = uiTicks;
-													this->bExpired = false; }
-
-signals:
-	void debugMessage(const QString &sMessage) const;
-	void gotEaten() const;
-	void timedOut(Bonus *pBonus) const;
-
-public slots:
-	inline void onDebugMessage(const QString &sMessage) const {
-		Q_EMIT this->debugMessage("Bonus:" + sMessage); }
-
-	virtual void onGotEaten();
-	virtual void onTick();
+	// for the pool
+	Bonus();
+	explicit Bonus(const QVector<QPoint> aoPoints, const quint8 ubStateBase,
+				   const bool bFake, MapGame *pMap);
+
+	inline bool contains(const QPoint oPoint) const { return this->aoPoints.contains(oPoint); }
+	// reverts the cells still showing this bonus, false if it does not have 4
+	bool defreezeCells() const;
+	inline quint32 expiry() const { return this->ulExpiry; }
+	inline QVector<QPoint> getPoints() const { return this->aoPoints; }
+	inline quint8 getStateBase() const { return this->ubStateBase; }
+	inline bool isFake() const { return this->bFake; }
+	inline bool isTimed() const { return 0u != this->uiTicks; }
+	inline void setStateBase(const quint8 ubState) { this->ubStateBase = ubState; }
+	// times out uiTicks after ulClock
+	inline void start(const quint32 ulClock, const uint uiTicks) {
+		this->uiTicks = uiTicks;
+		this->ulExpiry = ulClock + uiTicks; }
+
+	inline uint ticksLeft(const quint32 ulClock) const {
+		return this->uiTicks ? uint(this->ulExpiry - ulClock) : 0u; }
 
 }; // Bonus
 
@@ -24,7 +24,9 @@ namespace SwissalpS { namespace QtNibblers {
 
 
 
+#ifdef QT_MULTIMEDIA_LIB
 QHash<const Fx::Sounds, QSoundEffect*> Fx::aoSounds;
+#endif
 
 
 Fx::Fx(QObject *pParent) :
@@ -20,7 +20,9 @@
 
 #include <QObject>
 #include <QHash>
+#ifdef QT_MULTIMEDIA_LIB
 #include <QSoundEffect>
+#endif
 
 
 namespace SwissalpS { namespace QtNibblers {
@@ -16,10 +16,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Game.h"
+#include "Trace.h"
 
-#include "Fx.h"
-#include "IconEngine.h"
 
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QTime>
 
 
@@ -31,9 +33,12 @@ namespace SwissalpS { namespace QtNibblers {
 Game::Game(QObject *pParent) :
 	QObject(pParent),
 	bGameStarted(false),
+	bParallelAI(false),
 	bLevelStarted(false),
 	bPaused(true),
 	bUseFakes(false),
+	eAIEffort(WormAI::EffortFull),
+	ubAILookahead(0u),
 	ubCountAllPlayers(0u),
 	ubCountApplesLeft(13u),
 	ubCountBonus(0u),
@@ -47,26 +52,37 @@ Game::Game(QObject *pParent) :
 	ubCurrentLevel(0u),
 	ubSpeedIndex(0u),
 	ubStartLevel(0u),
+	uiAIBudget(0u),
+	iTickLongest(0),
+	ulCrashStamp(0u),
+	ulBonusClock(0u),
 	pAS(AppSettings::pAppSettings()),
 	pMapGame(nullptr),
 	pTimer(nullptr),
 	pTimerBonus(nullptr),
-	pWormAI(nullptr) {
-
-	this->apBonus.clear();
+	pPoolAI(nullptr),
+	oRandom(quint64(QDateTime::currentMSecsSinceEpoch())),
+	pReplay(nullptr),
+	pReplayFile(nullptr) {
+
+	for (int i = 0; i < 4; ++i) this->aulAIEffortTicks[i] = 0u;
+
+	this->aoBonuses.clear();
+	this->aiBonuses.clear();
+	this->aiBonusesFree.clear();
+	this->aaiBonusWheel.resize(int(SssS_Nibblers_Bonus_Wheel_Slots));
+	this->apCrashedWorms.clear();
 	this->apWorms.clear();
-
-	// init 'AI'
-	this->pWormAI = new WormAI(this);
-
-	// init randomizer
-	qsrand(uint(QTime::currentTime().msecsSinceStartOfDay()));
+	this->aulCrashGrid.clear();
+	this->apWormAIs.clear();
 
 } // construct
 
 
 Game::~Game() {
 
+	this->stopRecording();
+
 	this->destructBonuses();
 	this->destructWorms();
 
@@ -87,11 +103,38 @@ Game::~Game() {
 		this->pTimerBonus = nullptr;
 	}
 
-	delete this->pWormAI;
-	this->pWormAI = nullptr;
+	// waits for planners still running
+	delete this->pPoolAI;
+	this->pPoolAI = nullptr;
+
+	while (this->apWormAIs.length()) delete this->apWormAIs.takeLast();
 
 } // dealloc
 
+
+// AI may use half a tick, what came before it this tick included. When
+// it takes longer, next tick plans with less effort. When it takes less
+// than a quarter of that, effort goes back up one step.
+void Game::adaptAIEffort(const qint64 illBefore, const qint64 illCost) {
+
+	// only live games can run late
+	if ((nullptr == this->pTimer) || !this->pTimer->isActive()) return;
+
+	const qint64 illBudget = qint64(this->pTimer->interval()) * 500000 - illBefore;
+	int iEffort = this->eAIEffort;
+
+	if (illCost > illBudget) iEffort = qMin(iEffort + 1, int(WormAI::EffortReflex));
+	else if (illCost < illBudget / 4) iEffort = qMax(iEffort - 1, int(WormAI::EffortFull));
+
+	if (iEffort == this->eAIEffort) return;
+
+	this->eAIEffort = WormAI::Effort(iEffort);
+
+	if (this->pReplay) this->pReplay->recordAIEffort(quint8(iEffort));
+
+} // adaptAIEffort
+
+
 // slightly adapted from nibbles-game.vala NibblesGame.add_bonus(bool)
 // chances of each should be compareable to gnome-nibbles and it's ancestors.
 void Game::addBonus(const bool bApple) {
@@ -101,13 +144,13 @@ void Game::addBonus(const bool bApple) {
 
 		if (this->ubCountBonusMissed >= SssS_Nibblers_Bonus_Max_Missed) return;
 
-		if ((qrand() % 51) != 0) return;
+		if (this->oRandom.bounded(51u) != 0) return;
 
-		bool bMakeFake = ((qrand() % 8) != 0);
+		bool bMakeFake = (this->oRandom.bounded(8u) != 0);
 
 		if (bMakeFake && !this->bUseFakes) return;
 
-		switch (qrand() % 22) {
+		switch (this->oRandom.bounded(22u)) {
 
 			case 0: case 1: case 2: case 3: case 4:
 			case 5: case 6: case 7: case 8: case 9:
@@ -127,29 +170,28 @@ void Game::addBonus(const bool bApple) {
 					this->placeBonus(L::BonusDiamond, bMakeFake);
 			break;
 
-		} // switch qrand() % 22
+		} // switch random 0-21
 
 	} else {
 
 		// regular apple
 
 		// also add a fake?
-		if (this->bUseFakes	&& ((qrand() % 8) == 0)) {
+		if (this->bUseFakes	&& (this->oRandom.bounded(8u) == 0)) {
 
 			this->placeBonus(L::BonusApple, true);
 
 		} // if add a fake
 
 		// dirty fix to prevent more than one real apple at a time
-		Bonus *pBonus;
 		bool bHaveApple = false;
-		for (int i = 0; i < this->apBonus.length(); ++i) {
+		for (int i = 0; i < this->aiBonuses.length(); ++i) {
 
-			pBonus = this->apBonus.at(i);
+			const Bonus &oBonus = this->aoBonuses.at(this->aiBonuses.at(i));
 
-			if (pBonus->isFake()) continue;
+			if (oBonus.isFake()) continue;
 
-			if (pBonus->getStateBase() == L::BonusApple) {
+			if (oBonus.getStateBase() == L::BonusApple) {
 
 				this->onDebugMessage("wanted to place an apple when there was one already!!!!!!");
 				bHaveApple = true;
@@ -166,42 +208,139 @@ void Game::addBonus(const bool bApple) {
 } // addBonus
 
 
-// static
-void Game::addCrashPotential(QHash<QString, Worm *> &hppCrashPotential,
-							 QVector<Worm *> &apCrashedWorms,
-							 QPoint oPoint, Worm *pWorm) {
+void Game::addCrashPotential(const QPoint oPoint, const quint8 ubWorm) {
+
+	if (!this->pMapGame->contains(quint8(oPoint.x()), quint8(oPoint.y()))) return;
+
+	const int iCell = this->pMapGame->cellIndex(oPoint);
+	const quint32 ulEntry = this->aulCrashGrid.at(iCell);
+	if ((ulEntry >> 8) == this->ulCrashStamp) {
 
-	QString sKey = QString::number(oPoint.x()) + "_" + QString::number(oPoint.y());
-	if (hppCrashPotential.keys().contains(sKey)) {
+		Worm *pWorm = this->apWorms.at(ubWorm);
+		Worm *pWormOther = this->apWorms.at(ulEntry & 0xFFu);
 
 		// head-on-colision
-		if (!pWorm->isImmune()) apCrashedWorms.append(pWorm);
+		if (!pWorm->isImmune()) this->apCrashedWorms.append(pWorm);
 
-		if (!apCrashedWorms.contains(hppCrashPotential.value(sKey))) {
+		if (!this->apCrashedWorms.contains(pWormOther)) {
 
-			if (!hppCrashPotential.value(sKey)->isImmune())
-				apCrashedWorms.append(hppCrashPotential.value(sKey));
+			if (!pWormOther->isImmune()) this->apCrashedWorms.append(pWormOther);
 
 		} // if other worm needs to be added too
 
 		return;
 
-	} // if point is already in hash
+	} // if cell was already entered this tick
 
-	hppCrashPotential.insert(sKey, pWorm);
+	this->aulCrashGrid[iCell] = (this->ulCrashStamp << 8) | ubWorm;
 
 } // addCrashPotential
 
 
-void Game::destroyBonus(Bonus *pBonus) {
+void Game::attachMap() {
+
+	connect(this->pMapGame, SIGNAL(debugMessage(QString)),
+			this, SLOT(onDebugMessage(QString)));
+
+	connect(this->pMapGame, SIGNAL(tilesChanged(QVector<TileChange>)),
+			this, SIGNAL(tilesChanged(QVector<TileChange>)));
+
+	// the forward above always listens, what counts is whether anyone
+	// listens to us. Headless games have nobody drawing
+	this->pMapGame->setTileChangesWanted(
+				0 < this->receivers(SIGNAL(tilesChanged(QVector<TileChange>))));
+
+	// no stamp is 0, so the whole grid is free
+	this->aulCrashGrid.fill(0u, this->pMapGame->cellCount());
+	this->ulCrashStamp = 0u;
+
+	Q_EMIT this->loadLevel(this->pMapGame, this->ubCurrentLevel);
+
+} // attachMap
+
+
+int Game::createBonus(const QVector<QPoint> aoPoints, const quint8 ubBonus,
+					  const bool bFake, const uint uiTicks) {
+
+	int iBonus;
+	if (this->aiBonusesFree.isEmpty()) {
+
+		iBonus = this->aoBonuses.length();
+		this->aoBonuses.append(Bonus());
+
+	} else iBonus = this->aiBonusesFree.takeLast();
+
+	Bonus &oBonus = this->aoBonuses[iBonus];
+	oBonus = Bonus(aoPoints, ubBonus, bFake, this->pMapGame);
+	oBonus.start(this->ulBonusClock, uiTicks);
+
+	this->aiBonuses.prepend(iBonus);
+
+	// without ticks they never time out
+	if (oBonus.isTimed())
+		this->aaiBonusWheel[int(oBonus.expiry() & (SssS_Nibblers_Bonus_Wheel_Slots - 1u))]
+				.append(iBonus);
+
+	return iBonus;
+
+} // createBonus
+
+
+WormAI *Game::createWormAI(const int iWorm) {
+
+	const int iAI = iWorm - this->ubCountHumans;
+
+	if ((0 <= iAI) && (8 > iAI) && (this->ubAILookahead & (1u << iAI)))
+		return new WormAISearch(&this->oRandom, this);
+
+	return new WormAI(&this->oRandom, this);
+
+} // createWormAI
+
+
+void Game::createTimers() {
+
+	if (nullptr == this->pTimer) {
+
+		this->pTimer = new QTimer(this);
+		this->pTimer->setSingleShot(false);
+		this->pTimer->setTimerType(Qt::PreciseTimer);
+
+		connect(this->pTimer, SIGNAL(timeout()),
+				this, SLOT(onTick()));
+
+	} // if no tick timer yet
+
+	if (nullptr == this->pTimerBonus) {
+
+		this->pTimerBonus = new QTimer(this);
+		this->pTimerBonus->setSingleShot(false);
+		this->pTimerBonus->setTimerType(Qt::PreciseTimer);
+
+		connect(this->pTimerBonus, SIGNAL(timeout()),
+				this, SLOT(onTickBonus()));
+
+	} // if no bonus timer yet
+
+} // createTimers
+
+
+void Game::destroyBonus(const int iBonus) {
 
 	//this->onDebugMessage("destroyBonus");
 
-	pBonus->onGotEaten();
+	const Bonus &oBonus = this->aoBonuses.at(iBonus);
+
+	if (!oBonus.defreezeCells())
+		this->onDebugMessage("Error with cell count in Bonus::defreezeCells");
 
-	this->disconnect(pBonus);
-	this->apBonus.removeOne(pBonus);
-	pBonus->deleteLater();
+	// keeps the others in the order they time out in
+	if (oBonus.isTimed())
+		this->aaiBonusWheel[int(oBonus.expiry() & (SssS_Nibblers_Bonus_Wheel_Slots - 1u))]
+				.removeOne(iBonus);
+
+	this->aiBonuses.removeOne(iBonus);
+	this->aiBonusesFree.append(iBonus);
 
 } // destroyBonus
 
@@ -210,13 +349,17 @@ void Game::destructBonuses() {
 
 	//this->onDebugMessage("destructBonuses");
 
-	Bonus *pBonus;
-	while (this->apBonus.length()) {
+	// the map they were on is about to go, nothing to revert
+	for (int i = 0; i < this->aiBonuses.length(); ++i) {
+
+		if (this->aoBonuses.at(this->aiBonuses.at(i)).isTimed())
+			this->aaiBonusWheel[int(this->aoBonuses.at(this->aiBonuses.at(i)).expiry()
+									& (SssS_Nibblers_Bonus_Wheel_Slots - 1u))].clear();
 
-		pBonus = this->apBonus.takeLast();
-		delete pBonus;
+	} // loop bonuses
 
-	} // loop this->apBonus.length()
+	this->aiBonusesFree += this->aiBonuses;
+	this->aiBonuses.clear();
 
 } // destructBonuses
 
@@ -238,17 +381,56 @@ void Game::destructWorms() {
 } // destructWorms
 
 
+// hashed timing wheel: only the slot of the new clock is looked at, which
+// holds the bonuses due now and any due whole turns of the wheel later.
+// Due ones go oldest first, as when each bonus counted down on its own.
+void Game::expireBonuses() {
+
+	this->ulBonusClock++;
+
+	QVector<int> &aiSlot = this->aaiBonusWheel[
+			int(this->ulBonusClock & (SssS_Nibblers_Bonus_Wheel_Slots - 1u))];
+	int iBonus;
+	int i = 0;
+	while (i < aiSlot.length()) {
+
+		iBonus = aiSlot.at(i);
+
+		if (this->aoBonuses.at(iBonus).expiry() != this->ulBonusClock) {
+
+			++i;
+			continue;
+
+		} // if due in a later turn
+
+		// takes it out of aiSlot, a new apple lands in another turn
+		this->onBonusTimedOut(iBonus);
+
+	} // loop slot
+
+} // expireBonuses
+
+
 void Game::gameDone(const bool bGameWon) {
 
-	Fx::play(Fx::GameOver);
+	this->playFx(Fx::GameOver);
 
-	this->pTimer->stop();
-	this->pTimerBonus->stop();
+	this->stopTimers();
+	this->stopRecording();
 	this->bPaused = true;
 
 	this->ubCountDead = 0xFFu;
 	this->ubCountDeadHumans = 0xFFu;
 
+	if (this->aulAIEffortTicks[WormAI::EffortNearOnly]
+			|| this->aulAIEffortTicks[WormAI::EffortRegionsOnly]
+			|| this->aulAIEffortTicks[WormAI::EffortReflex])
+		this->onDebugMessage("AI ran late, ticks at effort full/near only/regions only/reflex: "
+							 + QString::number(this->aulAIEffortTicks[WormAI::EffortFull]) + "/"
+							 + QString::number(this->aulAIEffortTicks[WormAI::EffortNearOnly]) + "/"
+							 + QString::number(this->aulAIEffortTicks[WormAI::EffortRegionsOnly]) + "/"
+							 + QString::number(this->aulAIEffortTicks[WormAI::EffortReflex]));
+
 	QString sOut = bGameWon ? tr("Game Won") : tr("Game Over");
 	sOut += "\n";
 
@@ -290,24 +472,12 @@ void Game::init() {
 
 	this->onDebugMessage("init");
 
-	this->pTimer = new QTimer(this);
-	this->pTimer->setSingleShot(false);
-	this->pTimer->setTimerType(Qt::PreciseTimer);
+	this->createTimers();
 
-	connect(this->pTimer, SIGNAL(timeout()),
-			this, SLOT(onTick()));
-
-	this->pTimerBonus = new QTimer(this);
-	this->pTimerBonus->setSingleShot(false);
-	this->pTimerBonus->setTimerType(Qt::PreciseTimer);
-
-	connect(this->pTimerBonus, SIGNAL(timeout()),
-			this, SLOT(onTickBonus()));
-
-	this->onSpeedChanged(this->pAS->get(AppSettings::sSettingGameSpeed).toInt());
+	this->onSpeedChanged(this->setting(AppSettings::sSettingGameSpeed).toInt());
 
 	//this->loadCurrentLevel();
-	this->onStartNewGame(quint8(this->pAS->get(
+	this->onStartNewGame(quint8(this->setting(
 									AppSettings::sSettingGameStartLevel).toUInt()));
 
 } // init
@@ -326,8 +496,8 @@ void Game::initWorms() {
 
 	quint8 ubColour;
 	quint8 ubCount;
-	quint8 ubLives = quint8(this->pAS->get(AppSettings::sSettingGameStartLives).toUInt());
-	quint8 ubLivesMax = (this->pAS->get(AppSettings::sSettingGameLimitLives).toBool()) ? 0u : 2u * ubLives;
+	quint8 ubLives = quint8(this->setting(AppSettings::sSettingGameStartLives).toUInt());
+	quint8 ubLivesMax = (this->setting(AppSettings::sSettingGameLimitLives).toBool()) ? 0u : 2u * ubLives;
 
 	// check that there are enough spawn points
 	if (this->ubCountAllPlayers > this->pMapGame->spawnPoints().length()) {
@@ -348,7 +518,7 @@ void Game::initWorms() {
 	} // if not enough start points
 
 	// random spawn point distribution
-	this->pMapGame->randomizeSpawnOrder();
+	this->pMapGame->randomizeSpawnOrder(&this->oRandom);
 
 	QPoint oPoint;
 	quint8 ubState;
@@ -360,9 +530,10 @@ void Game::initWorms() {
 		oPoint = this->pMapGame->spawnPoints().at(ubCount);
 		ubState = this->pMapGame->tile(oPoint);
 
-		ubColour = this->pAS->getPlayerColour(ubCount);
+		ubColour = this->playerColour(ubCount);
 
-		pWorm = new Worm(oPoint, ubState, ubColour, (ubCount >= ubCountHumans), ubLivesMax, this);
+		pWorm = new Worm(oPoint, ubState, ubColour, (ubCount >= ubCountHumans),
+						 ubLivesMax, this->pMapGame, this);
 
 		if (!pWorm->isAI())
 			pWorm->setUseRelativeControls(this->pAS->getPlayerRelative(ubCount));
@@ -414,7 +585,7 @@ bool Game::isGameOver() {
 
 	//this->onDebugMessage("isGameOver");
 
-	bool bUseLastDeadMethod = this->pAS->get(
+	bool bUseLastDeadMethod = this->setting(
 								  AppSettings::sSettingGameOverOnLastDead).toBool();
 
 	if (this->ubCountHumans) {
@@ -463,9 +634,12 @@ void Game::loadCurrentLevel() {
 
 	this->onDebugMessage("loadCurrentLevel");
 
+	// bonuses belong to the map that is about to be replaced
+	this->destructBonuses();
+
 	bool bBadMap = true;
 	quint8 ubFirstLevel = this->ubCurrentLevel;
-	quint8 ubBMmode = quint8(this->pAS->get(AppSettings::sSettingGameBadLevelMode).toUInt());
+	quint8 ubBMmode = quint8(this->setting(AppSettings::sSettingGameBadLevelMode).toUInt());
 	QString sMessage;
 	QString sPath;
 
@@ -474,10 +648,14 @@ void Game::loadCurrentLevel() {
 	while (bBadMap) {
 
 		bBadMap = false;
-		sPath = this->pAS->getDataPathLevelFile(this->ubCurrentLevel);
+		sPath = this->levelFilePath(this->ubCurrentLevel);
 
 		delete this->pMapGame; this->pMapGame = nullptr;
 		this->pMapGame = MapGame::loadedMap(sPath, this);
+
+		for (int i = 0; i < this->apWorms.length(); ++i)
+			this->apWorms.at(i)->setMap(this->pMapGame);
+
 		if (MapGame::NoError != this->pMapGame->errorCode()) {
 
 			this->onDebugMessage("Load Error");
@@ -613,11 +791,9 @@ void Game::loadCurrentLevel() {
 
 	} // loop until good map found
 
-	connect(this->pMapGame, SIGNAL(debugMessage(QString)),
-			this, SLOT(onDebugMessage(QString)));
-
+	this->attachMap();
 
-	Q_EMIT this->loadLevel(this->pMapGame, this->ubCurrentLevel);
+	this->onLevelIsLoaded();
 
 } // loadCurrentLevel
 
@@ -724,19 +900,16 @@ QVector<Worm *> Game::makeRanking() {
 } // makeRanking
 
 
-void Game::onBonusPlaced(const QVector<SurfaceCell *> apCells, const bool bFake) {
-
-	Bonus *pBonus = new Bonus(apCells, bFake, this);
+void Game::onBonusPlaced(const QVector<QPoint> aoPoints, const quint8 ubBonus,
+						 const bool bFake) {
 
-	//this->onDebugMessage("onBonusPlaced " + QString::number(pBonus->getStateBase()) + " " + QString::number(apCells.at(0)->getPos().x()) + ":" + QString::number(apCells.at(0)->getPos().y()) + " " + QString::number(bFake));
+	//this->onDebugMessage("onBonusPlaced " + QString::number(ubBonus) + " " + QString::number(aoPoints.at(0).x()) + ":" + QString::number(aoPoints.at(0).y()) + " " + QString::number(bFake));
 
-	this->apBonus.prepend(pBonus);
-
-	if (L::BonusApple != pBonus->getStateBase()) Fx::play(Fx::Appear);
+	if (L::BonusApple != ubBonus) this->playFx(Fx::Appear);
 
 	// wich kind? how many ticks until expired?
 	quint16 uiTicks = 0u;
-	switch (pBonus->getStateBase()) {
+	switch (ubBonus) {
 
 		case L::BonusApple: // 100
 
@@ -772,35 +945,26 @@ void Game::onBonusPlaced(const QVector<SurfaceCell *> apCells, const bool bFake)
 
 		default:
 			this->onDebugMessage("unknown bonus encountered in Game::onBonusPlaced "
-								 + QString::number(pBonus->getStateBase()));
+								 + QString::number(ubBonus));
 		break;
 
-	} // switch pBonus->getStateBase()
-
-	pBonus->start(uiTicks);
-
-	connect(this, SIGNAL(move()),
-			pBonus, SLOT(onTick()));
-
-	connect(pBonus, SIGNAL(debugMessage(QString)),
-			this, SLOT(onDebugMessage(QString)));
+	} // switch ubBonus
 
-	connect(pBonus, SIGNAL(timedOut(Bonus*)),
-			this, SLOT(onBonusTimedOut(Bonus*)));
+	this->createBonus(aoPoints, ubBonus, bFake, uiTicks);
 
 } // onBonusPlaced
 
 
-void Game::onBonusTimedOut(Bonus *pBonus) {
+void Game::onBonusTimedOut(const int iBonus) {
 
-	//this->onDebugMessage("onBonusTimedOut" + QString::number(pBonus->getStateBase()) + " " + QString::number(pBonus->getCells().at(0)->getColumn()) + ":" + QString::number(pBonus->getCells().at(0)->getRow()) + " " + QString::number(pBonus->isFake()));
+	//this->onDebugMessage("onBonusTimedOut" + QString::number(pBonus->getStateBase()) + " " + QString::number(pBonus->getPoints().at(0).x()) + ":" + QString::number(pBonus->getPoints().at(0).y()) + " " + QString::number(pBonus->isFake()));
 
-	bool bWasApple = L::BonusApple == pBonus->getStateBase();
-	if (pBonus->isFake()) bWasApple = false;
+	bool bWasApple = L::BonusApple == this->aoBonuses.at(iBonus).getStateBase();
+	if (this->aoBonuses.at(iBonus).isFake()) bWasApple = false;
 	if (bWasApple) this->ubCountBonusMissed++;
 
 	// destroy Bonus
-	this->destroyBonus(pBonus);
+	this->destroyBonus(iBonus);
 
 	// spawn another if it was an apple
 	if (bWasApple) this->addBonus(true);
@@ -842,7 +1006,7 @@ void Game::onLevelIsLoaded() {
 //	this->onDebugMessage("OK, got enough spawn points");
 
 	// random spawn point distribution
-	this->pMapGame->randomizeSpawnOrder();
+	this->pMapGame->randomizeSpawnOrder(&this->oRandom);
 
 	QPoint oPoint;
 	quint8 ubState;
@@ -911,15 +1075,13 @@ void Game::onPauseResumeToggled() {
 
 			// do whatever to pause game
 
-			this->pTimer->stop();
-			this->pTimerBonus->stop();
+			this->stopTimers();
 
 		} else {
 
 			// do whatever to resume game
 
-			this->pTimer->start();
-			this->pTimerBonus->start();
+			this->startTimers();
 
 		} // if pause or resume game
 
@@ -948,13 +1110,12 @@ void Game::onResetSoft() {
 
 	this->onDebugMessage("onResetSoft " + QString::number(this->apWorms.length()));
 
-	this->apBonus.clear();
+	this->destructBonuses();
 
 	this->bLevelStarted = false;
 	this->bPaused = true;
 
-	this->pTimer->stop();
-	this->pTimerBonus->stop();
+	this->stopTimers();
 
 	this->ubCountBonus = 8u + quint8(this->apWorms.length());
 	this->ubCountApplesLeft = this->ubCountBonus;
@@ -968,7 +1129,7 @@ void Game::onResetSoft() {
 
 		if (pWorm->isDead()) continue;
 
-		Q_EMIT this->spawnWorm(pWorm);
+		this->spawnWorm(pWorm);
 
 	} // loop
 
@@ -980,9 +1141,9 @@ void Game::onReset() {
 
 	this->onDebugMessage("onReset");
 
-	this->bUseFakes = this->pAS->get(AppSettings::sSettingGameFakeBonuses).toBool();
+	this->bUseFakes = this->setting(AppSettings::sSettingGameFakeBonuses).toBool();
 
-	this->onSpeedChanged(this->pAS->get(AppSettings::sSettingGameSpeed).toInt());
+	this->onSpeedChanged(this->setting(AppSettings::sSettingGameSpeed).toInt());
 
 	this->ubCountDead = 0u;
 	this->ubCountDeadHumans = 0u;
@@ -1041,6 +1202,22 @@ void Game::onSpeedChanged(const int iIndex) {
 } // onSpeedChanged
 
 
+void Game::startTimers() {
+
+	this->pTimer->start();
+	this->pTimerBonus->start();
+
+} // startTimers
+
+
+void Game::stopTimers() {
+
+	this->pTimer->stop();
+	this->pTimerBonus->stop();
+
+} // stopTimers
+
+
 void Game::onStartNewGame(const quint8 ubLevel) {
 
 	this->onDebugMessage("onStartNewGame");
@@ -1052,31 +1229,54 @@ void Game::onStartNewGame(const quint8 ubLevel) {
 	this->bLevelStarted = false;
 
 	this->destructWorms();
+	this->bParallelAI = this->setting(AppSettings::sSettingGameParallelAI).toBool();
+	this->ubAILookahead = quint8(this->setting(AppSettings::sSettingGameAILookahead).toUInt());
+	this->uiAIBudget = quint16(this->setting(AppSettings::sSettingGameAIBudget).toUInt());
+	this->eAIEffort = WormAI::EffortFull;
+	for (int i = 0; i < 4; ++i) this->aulAIEffortTicks[i] = 0u;
+
+	// engines may differ from last game
+	while (this->apWormAIs.length()) delete this->apWormAIs.takeLast();
 
-	quint8 ubCountAIs = quint8(this->pAS->get(AppSettings::sSettingGameCountAIs).toUInt());
-	this->ubCountHumans = quint8(this->pAS->get(AppSettings::sSettingGameCountHumans).toUInt());
+	quint8 ubCountAIs = quint8(this->setting(AppSettings::sSettingGameCountAIs).toUInt());
+	this->ubCountHumans = quint8(this->setting(AppSettings::sSettingGameCountHumans).toUInt());
 	this->ubCountAllPlayers = this->ubCountHumans + ubCountAIs;
 
+	// before anything random happens
+	this->stopRecording();
+	if (this->setting(AppSettings::sSettingGameRecordReplays).toBool())
+		this->recordToFile();
+
 	this->loadCurrentLevel();
 
 } // onStartNewGame
 
 
-void Game::onTileChanged(const QPoint oPoint, const quint8 ubState) {
+void Game::onTick() {
 
-	//this->onDebugMessage("onTC " + QString::number(oPoint.x()) + ":" + QString::number(oPoint.y()) + " " + QString::number(ubState));
-	this->pMapGame->setTile(oPoint, ubState);
+	int iElapsedLast = this->oTimeTick.elapsed();
+	this->oTimeTick.start();
+	this->oClockAI.start();
+	int iElapsed;
 
-} // onTileChanged
+	SssS_Nibblers_Trace_Tick();
+	SssS_Nibblers_Trace_Span(PhaseTick);
 
+	// whatever the tick does to tiles is reported at its end in one go
+	this->pMapGame->beginTileChanges();
 
-void Game::onTick() {
+	SssS_Nibblers_Trace_Begin(PhaseInput);
 
-	static QTime oTime;
-	int iElapsedLast = oTime.elapsed();
-	oTime.start();
-	int iElapsed;
-	static int iLongest = 0;
+	if (this->pReplay) {
+
+		if (this->pReplay->isKeyframeDue())
+			this->pReplay->recordKeyframe(this->saveState());
+
+		this->pReplay->recordTick(this->apWorms);
+
+	} // if recording
+
+	SssS_Nibblers_Trace_End(PhaseInput);
 
 	//this->onDebugMessage("onTick");
 
@@ -1100,35 +1300,31 @@ void Game::onTick() {
 
 	} // if penalty
 
-	Q_EMIT this->move();
-
-	static QVector<quint8> aStatesPickups;
-	static QVector<quint8> aStatesSnakes;
-	static QVector<quint8> aStatesSpawns;
-	static QVector<quint8> aStatesTeleporterEntrances;
-	static QVector<quint8> aStatesTeleporterExits;
-	static QVector<quint8> aStatesWalls;
-	if (aStatesPickups.isEmpty()) {
-
-		aStatesPickups = IconEngine::statesPickups();
-		aStatesSnakes = IconEngine::statesSnakes();
-		aStatesSpawns = IconEngine::statesSpawns();
-		aStatesTeleporterEntrances = IconEngine::statesTeleporterEntrances();
-		aStatesTeleporterExits = IconEngine::statesTeleporterExits();
-		aStatesWalls = IconEngine::statesWalls();
-
-	} // if first call
+	SssS_Nibblers_Trace_Begin(PhaseBonus);
+	this->expireBonuses();
+	SssS_Nibblers_Trace_End(PhaseBonus);
 
 	Worm *pWorm;
+	bool bPlanned = false;
+	L::Heading eHeading;
+	qint64 illBefore;
 	QPoint oPoint;
 	QPoint oPointTeleporter;
 	quint8 ubState;
-	// keep track of cells that are being newly occupied
-	QHash<QString, Worm *> hopCrashPotential;
 	// keep track of worms that are crashing
-	QVector<Worm *> apCrashedWorms;
-	hopCrashPotential.clear();
-	apCrashedWorms.clear();
+	this->apCrashedWorms.clear();
+
+	// a new stamp frees all cells entered in earlier ticks
+	if (0xFFFFFFu == this->ulCrashStamp) {
+
+		this->aulCrashGrid.fill(0u);
+		this->ulCrashStamp = 0u;
+
+	} // if stamps are used up
+
+	this->ulCrashStamp++;
+
+	SssS_Nibblers_Trace_Begin(PhaseMovement);
 
 	// collect immediate threats and goodies
 	for (int i = 0; i < this->apWorms.length(); ++i) {
@@ -1143,43 +1339,40 @@ void Game::onTick() {
 		if (pWorm->isImmune()) {
 
 			// others may crash? Maybe better not
-			//addCrashPotential(hppCrashPotential, apCrashedWorms, pCell, pWorm);
+			//this->addCrashPotential(oPoint, quint8(i));
 
 			// TODO: check bonus, not to give a spawning worm points,
 			// but to make sure it is drawn again
 
-			Q_EMIT this->advanceWormTo(pWorm, oPoint);
+			pWorm->advanceTo(oPoint);
 
 			continue;
 
 		} // if immune worm
 
-		if (aStatesSnakes.contains(ubState)
-				|| aStatesWalls.contains(ubState)) {
+		if (L::isTile(ubState, L::ClassSolid)) {
 
 			// crash
-			apCrashedWorms.append(pWorm);
+			this->apCrashedWorms.append(pWorm);
 			continue;
 
 		} // if crashed
 
-		if (aStatesTeleporterEntrances.contains(ubState)) {
+		if (L::isTile(ubState, L::ClassTeleporterIn)) {
 
 			// enter teleporter
 			oPointTeleporter = this->pMapGame->teleporterOutForIn(ubState);
 			if (0xFF > oPointTeleporter.x()) {
 
-				Fx::play(Fx::Teleport);
+				this->playFx(Fx::Teleport);
 
 				// add both entrance and exit to crash potentials
-				Game::addCrashPotential(hopCrashPotential, apCrashedWorms,
-								  oPoint, pWorm);
-				Game::addCrashPotential(hopCrashPotential, apCrashedWorms,
-								  oPointTeleporter, pWorm);
+				this->addCrashPotential(oPoint, quint8(i));
+				this->addCrashPotential(oPointTeleporter, quint8(i));
 
 				// advance to both locations
-				Q_EMIT this->advanceWormTo(pWorm, oPoint);
-				Q_EMIT this->advanceWormTo(pWorm, oPointTeleporter);
+				pWorm->advanceTo(oPoint);
+				pWorm->advanceTo(oPointTeleporter);
 
 				continue;
 
@@ -1187,35 +1380,39 @@ void Game::onTick() {
 
 		} // if teleporter entrance encountered
 
-		if (aStatesPickups.contains(ubState)) {
+		if (L::isTile(ubState, L::ClassPickup)) {
 
 			// advance worm
-			Q_EMIT this->advanceWormTo(pWorm, oPoint);
+			pWorm->advanceTo(oPoint);
 
 			// figure out which bonus it is
 			this->wormAteBonus(pWorm, oPoint);
 			Q_EMIT this->wormAteBonus(pWorm);
 
-			Game::addCrashPotential(hopCrashPotential,apCrashedWorms, oPoint, pWorm);
+			this->addCrashPotential(oPoint, quint8(i));
 
 		} else {
 
 			// any free cell
-			Q_EMIT this->advanceWormTo(pWorm, oPoint);
+			pWorm->advanceTo(oPoint);
 
-			Game::addCrashPotential(hopCrashPotential, apCrashedWorms,
-									oPoint, pWorm);
+			this->addCrashPotential(oPoint, quint8(i));
 
 		} // if picked up something
 
 	} // loop
 
+	SssS_Nibblers_Trace_End(PhaseMovement);
+	SssS_Nibblers_Trace_Begin(PhaseCollision);
+
 	// deal with crashed worms
-	for (int i = 0; i < apCrashedWorms.length(); ++i) {
+	for (int i = 0; i < this->apCrashedWorms.length(); ++i) {
 
-		Fx::play(Fx::Crash);
+		this->playFx(Fx::Crash);
 
-		pWorm = apCrashedWorms.at(i);
+		pWorm = this->apCrashedWorms.at(i);
+
+		pWorm->removeFromMap();
 
 		Q_EMIT this->wormCrashed(pWorm);
 
@@ -1227,11 +1424,78 @@ void Game::onTick() {
 
 		} // if more than one player -> penalty points
 
-		if (!pWorm->isDead()) Q_EMIT this->spawnWorm(pWorm);
+		if (!pWorm->isDead()) this->spawnWorm(pWorm);
 
 	} // loop crashed worms
 
-	// do AI-moves
+	SssS_Nibblers_Trace_End(PhaseCollision);
+	SssS_Nibblers_Trace_Begin(PhaseAI);
+
+	// do AI-moves, first let every AI decide on the same board
+	while (this->apWormAIs.length() < this->apWorms.length())
+		this->apWormAIs.append(this->createWormAI(this->apWormAIs.length()));
+
+	if (this->bParallelAI && (nullptr == this->pPoolAI))
+		this->pPoolAI = new QThreadPool();
+
+	for (int i = 0; i < this->apWorms.length(); ++i) {
+
+		pWorm = this->apWorms.at(i);
+		if (pWorm->isAI() && !pWorm->isDead()) {
+
+			// regions spare most AI from flooding the board themselves
+			this->pMapGame->labelRegions(WormAI::headCells(this->apWorms, this->pMapGame));
+			// as are straight walks, threads below only read either
+			this->pMapGame->refreshLines();
+			bPlanned = true;
+
+			break;
+
+		} // if found a living AI
+
+	} // loop worms
+
+	// one deadline for all, whether they plan at once or not
+	illBefore = this->oClockAI.nsecsElapsed();
+
+	for (int i = 0; i < this->apWorms.length(); ++i) {
+
+		pWorm = this->apWorms.at(i);
+
+		if (!pWorm->isAI()) continue;
+
+		if (pWorm->isDead()) continue;
+
+		// its headings come from the replay
+		if (this->isReplaying() && this->apWormAIs.at(i)->isRecorded()) continue;
+
+		this->apWormAIs.at(i)->setDeadline(this->uiAIBudget ? &this->oClockAI : nullptr,
+										   illBefore + qint64(this->uiAIBudget) * 1000);
+		this->apWormAIs.at(i)->setEffort(this->eAIEffort);
+
+		if (this->bParallelAI) {
+
+			this->apWormAIs.at(i)->setPlan(pWorm, this->apWorms, this->pMapGame);
+			this->pPoolAI->start(this->apWormAIs.at(i));
+
+		} else this->apWormAIs.at(i)->plan(pWorm, this->apWorms, this->pMapGame);
+
+	} // loop worms
+
+	if (this->bParallelAI) this->pPoolAI->waitForDone();
+
+	if (bPlanned) {
+
+		this->aulAIEffortTicks[this->eAIEffort]++;
+
+		// replays bring their own
+		if (!this->isReplaying())
+			this->adaptAIEffort(illBefore, this->oClockAI.nsecsElapsed() - illBefore);
+
+	} // if AI planned
+
+	// then turn them in worm order, which is the order random numbers
+	// were always drawn in
 	for (int i = 0; i < this->apWorms.length(); ++i) {
 
 		pWorm = this->apWorms.at(i);
@@ -1240,21 +1504,45 @@ void Game::onTick() {
 
 		if (pWorm->isDead()) continue;
 
-		this->pWormAI->move(pWorm, this->apWorms, this->pMapGame);
+		if (!this->apWormAIs.at(i)->isRecorded()) {
+
+			this->apWormAIs.at(i)->move(pWorm);
+
+			continue;
+
+		} // if follows from random state
+
+		if (this->isReplaying()) continue;
+
+		eHeading = pWorm->currentDirection();
+		this->apWormAIs.at(i)->move(pWorm);
+
+		if (this->pReplay && (eHeading != pWorm->currentDirection()))
+			this->pReplay->recordHeading(i, pWorm->currentDirection());
 
 	} // loop worms
 
-	iElapsed = oTime.elapsed();
-	//this->onDebugMessage(QString::number(iElapsedLast) + " :since last | used ms: " + QString::number(iElapsed) + " longest: " + QString::number(iLongest));
-	if (iElapsed > iLongest) iLongest = iElapsed;
+	SssS_Nibblers_Trace_End(PhaseAI);
+
+	this->pMapGame->endTileChanges();
+
+	iElapsed = this->oTimeTick.elapsed();
+	//this->onDebugMessage(QString::number(iElapsedLast) + " :since last | used ms: " + QString::number(iElapsed) + " longest: " + QString::number(this->iTickLongest));
+	if (iElapsed > this->iTickLongest) this->iTickLongest = iElapsed;
 
 } // onTick
 
 
 void Game::onTickBonus() {
 
+	SssS_Nibblers_Trace_Span(PhaseBonus);
+
 	//this->onDebugMessage("onTickBonus " + QString::number(this->ubCountNeedApple));
 
+	if (this->pReplay) this->pReplay->recordBonusTick();
+
+	this->pMapGame->beginTileChanges();
+
 	// give time for space to appear for bonus apples
 	// which really need to be in existance or game stalls
 	if (this->ubCountNeedApple) {
@@ -1265,6 +1553,8 @@ void Game::onTickBonus() {
 	// randomly add any other kind of bonus
 	this->addBonus(false);
 
+	this->pMapGame->endTileChanges();
+
 } // onTickBonus
 
 
@@ -1286,7 +1576,7 @@ void Game::placeBonus(const quint8 ubBonus, const bool bFake) {
 	//this->onDebugMessage("placeBonus");
 
 	// find 4 adjacent cells that are not occupied
-	QVector<QPoint>aoPoints = this->pMapGame->freeSpotForBonus();
+	QVector<QPoint>aoPoints = this->pMapGame->freeSpotForBonus(&this->oRandom);
 	if (aoPoints.isEmpty()) {
 
 		if ((!bFake) && (L::BonusApple == ubBonus)) {
@@ -1301,11 +1591,253 @@ void Game::placeBonus(const quint8 ubBonus, const bool bFake) {
 
 	} // if no space for bonus
 
-	Q_EMIT this->bonusPlaced(aoPoints, ubBonus, bFake);
+	this->pMapGame->setTile(aoPoints.first(), ubBonus);
+	this->pMapGame->setTile(aoPoints.at(1), ubBonus + 1u);
+	this->pMapGame->setTile(aoPoints.at(2), ubBonus + 2u);
+	this->pMapGame->setTile(aoPoints.last(), ubBonus + 3u);
+
+	this->onBonusPlaced(aoPoints, ubBonus, bFake);
 
 } // placeBonus
 
 
+void Game::recordToFile() {
+
+	QString sPath = this->pAS->getDataPath() + "Replays/";
+	if (!QDir().mkpath(sPath)) {
+
+		this->onDebugMessage("Can not create directory for replays " + sPath);
+
+		return;
+
+	} // if no directory
+
+	QFile *pFile = new QFile(sPath + QDateTime::currentDateTime().toString(
+								 "yyyyMMdd-hhmmss-zzz") + ".nibr", this);
+
+	if (!pFile->open(QIODevice::WriteOnly)) {
+
+		this->onDebugMessage("Can not open replay file " + pFile->fileName());
+		delete pFile;
+
+		return;
+
+	} // if can not open
+
+	if (!this->startRecording(pFile)) {
+
+		delete pFile;
+
+		return;
+
+	} // if failed to start
+
+	this->pReplayFile = pFile;
+
+} // recordToFile
+
+
+bool Game::restoreState(const QByteArray &aState) {
+
+	QDataStream oStream(aState);
+	oStream.setVersion(QDataStream::Qt_5_6);
+
+	quint8 ubLevel;
+	quint32 aulRandom[4];
+	oStream >> ubLevel >> this->ubCountApplesLeft >> this->ubCountBonus
+			>> this->ubCountBonusLeft >> this->ubCountBonusMissed
+			>> this->ubCountDead >> this->ubCountDeadHumans
+			>> this->ubCountLevels >> this->ubCountNeedApple
+			>> aulRandom[0] >> aulRandom[1] >> aulRandom[2] >> aulRandom[3];
+
+	this->oRandom.setState(aulRandom);
+
+	this->stopTimers();
+	this->destructBonuses();
+
+	// frozen tiles and teleporters come from the level file
+	if ((nullptr == this->pMapGame) || (ubLevel != this->ubCurrentLevel)) {
+
+		this->ubCurrentLevel = ubLevel;
+
+		delete this->pMapGame;
+		this->pMapGame = MapGame::loadedMap(this->levelFilePath(ubLevel), this);
+
+		if (MapGame::NoError != this->pMapGame->errorCode()) return false;
+
+		this->attachMap();
+
+	} // if other level
+
+	this->pMapGame->readState(oStream);
+
+	quint8 ubCount;
+	oStream >> ubCount;
+	if (ubCount != this->apWorms.length()) return false;
+
+	Worm *pWorm;
+	for (int i = 0; i < this->apWorms.length(); ++i) {
+
+		pWorm = this->apWorms.at(i);
+		pWorm->setMap(this->pMapGame);
+		pWorm->readState(oStream);
+
+	} // loop worms
+
+	bool bFake;
+	quint8 ubBonus;
+	quint8 ubX;
+	quint8 ubY;
+	quint16 uiTicks;
+	QVector<QPoint> aoPoints;
+	oStream >> ubCount;
+	for (quint8 ub = 0u; ub < ubCount; ++ub) {
+
+		aoPoints.clear();
+		for (int i = 0; i < 4; ++i) {
+
+			oStream >> ubX >> ubY;
+			aoPoints.append(QPoint(ubX, ubY));
+
+		} // loop points
+
+		oStream >> ubBonus >> bFake >> uiTicks;
+
+		this->createBonus(aoPoints, ubBonus, bFake, uiTicks);
+
+	} // loop bonuses
+
+	oStream >> ubBonus;
+	this->eAIEffort = WormAI::Effort(ubBonus & 3u);
+
+	// level is running but paused, like after pressing pause
+	this->bGameStarted = true;
+	this->bLevelStarted = true;
+	this->bPaused = true;
+
+	return QDataStream::Ok == oStream.status();
+
+} // restoreState
+
+
+QByteArray Game::saveState() const {
+
+	QByteArray aState;
+	QDataStream oStream(&aState, QIODevice::WriteOnly);
+	oStream.setVersion(QDataStream::Qt_5_6);
+
+	quint32 aulRandom[4];
+	this->oRandom.getState(aulRandom);
+
+	oStream << this->ubCurrentLevel << this->ubCountApplesLeft << this->ubCountBonus
+			<< this->ubCountBonusLeft << this->ubCountBonusMissed
+			<< this->ubCountDead << this->ubCountDeadHumans
+			<< this->ubCountLevels << this->ubCountNeedApple
+			<< aulRandom[0] << aulRandom[1] << aulRandom[2] << aulRandom[3];
+
+	this->pMapGame->writeState(oStream);
+
+	oStream << quint8(this->apWorms.length());
+	for (int i = 0; i < this->apWorms.length(); ++i)
+		this->apWorms.at(i)->writeState(oStream);
+
+	// oldest first so those due on the same tick time out in the same order
+	QVector<QPoint> aoPoints;
+	oStream << quint8(this->aiBonuses.length());
+	for (int i = this->aiBonuses.length() - 1; 0 <= i; --i) {
+
+		const Bonus &oBonus = this->aoBonuses.at(this->aiBonuses.at(i));
+		aoPoints = oBonus.getPoints();
+		for (int j = 0; j < 4; ++j)
+			oStream << quint8(aoPoints.value(j).x()) << quint8(aoPoints.value(j).y());
+
+		oStream << oBonus.getStateBase() << oBonus.isFake()
+				<< quint16(oBonus.ticksLeft(this->ulBonusClock));
+
+	} // loop bonuses
+
+	oStream << quint8(this->eAIEffort);
+
+	return aState;
+
+} // saveState
+
+
+void Game::spawnWorm(Worm *pWorm) {
+
+	//this->onDebugMessage("spawnWorm");
+
+	pWorm->startSpawning();
+
+	pWorm->advanceTo(pWorm->spawnPoint());
+	pWorm->advanceTo(pWorm->nextPoint());
+	pWorm->advanceTo(pWorm->nextPoint());
+	pWorm->advanceTo(pWorm->nextPoint());
+	pWorm->advanceTo(pWorm->nextPoint());
+
+} // spawnWorm
+
+
+bool Game::startRecording(QIODevice *pDevice) {
+
+	this->stopRecording();
+
+	this->pReplay = new Replay(this);
+
+	quint32 aulState[4];
+	this->oRandom.getState(aulState);
+	this->pReplay->setRandomState(aulState);
+	this->pReplay->setLevel(this->ubCurrentLevel);
+
+	const QStringList asKeys = Replay::settingKeys();
+	for (int i = 0; i < asKeys.length(); ++i)
+		this->pReplay->setSetting(asKeys.at(i), this->setting(asKeys.at(i)));
+
+	QList<QVariant> aColours;
+	for (quint8 ubWorm = 0u; ubWorm < SssS_Nibblers_Max_Players; ++ubWorm)
+		aColours.append(uint(this->playerColour(ubWorm)));
+
+	this->pReplay->setSetting(AppSettings::sSettingGameColours, aColours);
+	this->pReplay->setKeyframeTicks(this->setting(
+										AppSettings::sSettingGameReplayKeyframeTicks).toUInt());
+
+	if (this->pReplay->startRecording(pDevice)) return true;
+
+	delete this->pReplay;
+	this->pReplay = nullptr;
+
+	return false;
+
+} // startRecording
+
+
+void Game::stopRecording() {
+
+	bool bEmpty = true;
+	if (this->pReplay) {
+
+		bEmpty = (0u == this->pReplay->ticksRecorded());
+
+		this->pReplay->stopRecording();
+		delete this->pReplay;
+		this->pReplay = nullptr;
+
+	} // if recording
+
+	if (this->pReplayFile) {
+
+		// game was never started
+		if (bEmpty) this->pReplayFile->remove();
+		else this->pReplayFile->close();
+
+		delete this->pReplayFile;
+		this->pReplayFile = nullptr;
+
+	} // if own file
+
+} // stopRecording
+
+
 void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 	//this->onDebugMessage("wormAteBonus");
@@ -1314,15 +1846,15 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 	// first find the bonus in our cache
 	quint8 ubState = 0u;
-	Bonus *pBonus = nullptr;
-	for (int i = 0; i < this->apBonus.length(); ++i) {
+	int iBonus = -1;
+	for (int i = 0; i < this->aiBonuses.length(); ++i) {
 
-		pBonus = this->apBonus.at(i);
+		iBonus = this->aiBonuses.at(i);
 
-		if (!pBonus->contains(oPoint)) continue;
+		if (!this->aoBonuses.at(iBonus).contains(oPoint)) continue;
 
 		// found it, retrieve state
-		ubState = pBonus->getStateBase();
+		ubState = this->aoBonuses.at(iBonus).getStateBase();
 
 		break;
 
@@ -1337,21 +1869,19 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 	//this->onDebugMessage("Worm ate bonus " + QString::number(ubState) + " " + QString::number(oPoint.x()) + ":" + QString::number(oPoint.y()));
 
 	// OK, found it and have state
-	// so tell good-bye
-	pBonus->onGotEaten();
+	// so tell good-bye, which reverts its other cells
+	const bool bFake = this->aoBonuses.at(iBonus).isFake();
+	this->destroyBonus(iBonus);
 
-	if (pBonus->isFake()) {
+	if (bFake) {
 
-		Fx::play(Fx::Reverse);
+		this->playFx(Fx::Reverse);
 
 		pWorm->onReverse();
-		this->destroyBonus(pBonus);
 		return;
 
 	} // if it's a fake
 
-	// destroy it and remove it from cache
-	this->destroyBonus(pBonus);
 
 	// now let's react to it with points and growth
 	quint16 uiScore;
@@ -1359,7 +1889,7 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 		case L::BonusApple:
 
-			Fx::play(Fx::Gobble);
+			this->playFx(Fx::Gobble);
 
 			//this->onDebugMessage("cB " + QString::number(this->ubCountBonus) + " cAl " + QString::number(this->ubCountApplesLeft));
 
@@ -1380,8 +1910,7 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 				if (0u == this->ubCountApplesLeft) {
 
 					this->bPaused = true;
-					this->pTimer->stop();
-					this->pTimerBonus->stop();
+					this->stopTimers();
 					this->bLevelStarted = false;
 
 					for (int i = 0; i < this->apWorms.length(); ++i) {
@@ -1405,7 +1934,7 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 		case L::BonusCherry:
 
-			Fx::play(Fx::Bonus);
+			this->playFx(Fx::Bonus);
 
 			if (2 >= pWorm->targetLength()) break;
 
@@ -1422,7 +1951,7 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 		case L::BonusBanana:
 
-			Fx::play(Fx::Bonus);
+			this->playFx(Fx::Bonus);
 
 			// add points
 			uiScore = qMax(qint16(1), qint16(pWorm->targetLength() * this->ubCountLevels));
@@ -1435,7 +1964,7 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 		case L::BonusHeart:
 
-			Fx::play(Fx::Life);
+			this->playFx(Fx::Life);
 
 			// no points
 			// no growth
@@ -1446,7 +1975,7 @@ void Game::wormAteBonus(Worm *pWorm, const QPoint oPoint) {
 
 		case L::BonusDiamond:
 
-			Fx::play(Fx::Reverse);
+			this->playFx(Fx::Reverse);
 
 			// no points
 			// no growth
@@ -18,14 +18,22 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <QElapsedTimer>
+#include <QFile>
 #include <QObject>
+#include <QThreadPool>
+#include <QTime>
 #include <QTimer>
 #include "AppSettings.h"
 #include "Bonus.h"
+#include "Fx.h"
 #include "HistoryItem.h"
 #include "MapGame.h"
+#include "Random.h"
+#include "Replay.h"
 #include "Worm.h"
 #include "WormAI.h"
+#include "WormAISearch.h"
 
 
 
@@ -41,9 +49,15 @@ private:
 
 protected:
 	bool bGameStarted;
+	// plan AI moves on pPoolAI instead of one after the other
+	bool bParallelAI;
 	bool bLevelStarted;
 	bool bPaused;
 	bool bUseFakes;
+	// effort AI plans with, see adaptAIEffort()
+	WormAI::Effort eAIEffort;
+	// bit n set: AI n uses WormAISearch
+	quint8 ubAILookahead;
 	quint8 ubCountAllPlayers;
 	quint8 ubCountApplesLeft;
 	quint8 ubCountBonus;
@@ -57,27 +71,93 @@ protected:
 	quint8 ubCurrentLevel;
 	quint8 ubSpeedIndex;
 	quint8 ubStartLevel;
+	// microseconds AI may use per tick, 0 for no limit
+	quint16 uiAIBudget;
+	int iTickLongest;
+	// increases every tick, see aulCrashGrid
+	quint32 ulCrashStamp;
+	// increases every tick, see expireBonuses()
+	quint32 ulBonusClock;
 	AppSettings *pAS;
 	MapGame *pMapGame;
-	QVector<Bonus *> apBonus;
+	// pool of bonuses, entries not in aiBonuses are free for the next one
+	QVector<Bonus> aoBonuses;
+	// indices of bonuses on the board in aoBonuses, newest first
+	QVector<int> aiBonuses;
+	QVector<int> aiBonusesFree;
+	// per slot the indices of bonuses timing out at clocks of that slot,
+	// oldest first
+	QVector<QVector<int> > aaiBonusWheel;
 	QVector<Worm *> apWorms;
+	// worms crashing this tick, kept to not allocate every tick
+	QVector<Worm *> apCrashedWorms;
+	// one entry per cell: stamp of tick it was last entered in upper
+	// 24 bits, index of worm that entered it in lower 8 bits
+	QVector<quint32> aulCrashGrid;
 	QTimer *pTimer;
 	QTimer *pTimerBonus;
-	WormAI *pWormAI;
-
+	QTime oTimeTick;
+	// started every tick, see uiAIBudget and adaptAIEffort()
+	QElapsedTimer oClockAI;
+	// per WormAI::Effort, ticks AI planned with it
+	quint32 aulAIEffortTicks[4];
+	// one per worm, so they can plan at the same time, see WormAI
+	QVector<WormAI *> apWormAIs;
+	// created on first use
+	QThreadPool *pPoolAI;
+	// all randomness of a game comes from here
+	Random oRandom;
+	// set while recording
+	Replay *pReplay;
+	QFile *pReplayFile;
+
+	// picks effort of next tick from illCost ns AI planned this tick,
+	// which started illBefore ns into it
+	virtual void adaptAIEffort(const qint64 illBefore, const qint64 illCost);
 	virtual void addBonus(const bool bApple);
-	static void addCrashPotential(QHash<QString, Worm *> &hppCrashPotential,
-								  QVector<Worm *> &apCrashedWorms,
-								  QPoint oPoint, Worm *pWorm);
-
-	virtual void destroyBonus(Bonus *pBonus);
+	// worm ubWorm enters oPoint, it and whoever entered it first this tick
+	// are added to apCrashedWorms
+	virtual void addCrashPotential(const QPoint oPoint, const quint8 ubWorm);
+
+	// connects freshly loaded map and tells surface about it
+	virtual void attachMap();
+	// index in aoBonuses
+	virtual int createBonus(const QVector<QPoint> aoPoints, const quint8 ubBonus,
+							const bool bFake, const uint uiTicks);
+
+	// the engine ubAILookahead picks for worm iWorm
+	virtual WormAI *createWormAI(const int iWorm);
+	// makes pTimer and pTimerBonus unless they already exist
+	virtual void createTimers();
+	virtual void destroyBonus(const int iBonus);
 	virtual void destructBonuses();
 	virtual void destructWorms();
+	// advances ulBonusClock and times out the bonuses due
+	virtual void expireBonuses();
 	virtual void gameDone(const bool bGameWon);
 	virtual void initWorms();
+	// playing a replay, AI that isRecorded() does not plan then
+	inline virtual bool isReplaying() const { return false; }
+	inline virtual QString levelFilePath(const quint8 ubLevel) {
+		return this->pAS->getDataPathLevelFile(ubLevel); }
+
 	virtual void loadCurrentLevel();
 	virtual QVector<Worm *> makeRanking();
+	virtual void onBonusTimedOut(const int iBonus);
 	virtual void placeBonus(const quint8 ubBonus, const bool bFake);
+	// records to a new file in data path's Replays directory
+	virtual void recordToFile();
+	inline virtual void playFx(const Fx::Sounds eSound) const { Fx::play(eSound); }
+	inline virtual quint8 playerColour(const quint8 ubWorm) const {
+		return this->pAS->getPlayerColour(ubWorm); }
+
+	// all settings are read through here so subclasses can keep their own
+	inline virtual QVariant setting(const QString sKey) const {
+		return this->pAS->get(sKey); }
+
+	virtual void spawnWorm(Worm *pWorm);
+	virtual void startTimers();
+	virtual void stopTimers();
 	virtual void wormAteBonus(Worm *pWorm, const QPoint oPoint);
 
 protected slots:
@@ -88,24 +168,39 @@ public:
 	explicit Game(QObject *pParent = nullptr);
 	virtual ~Game();
 
+	// ticks AI planned with eEffort this game
+	inline virtual quint32 aiEffortTicks(const WormAI::Effort eEffort) const {
+		return this->aulAIEffortTicks[eEffort & 3]; }
+
 	void init();
 	virtual bool isGameOver();
 	inline virtual bool isPaused() { return this->bPaused; }
+	// continues the game at a state from saveState() of same game, leaves it
+	// paused. Returns false if state does not fit, game is unusable then.
+	virtual bool restoreState(const QByteArray &aState);
+	// board, worms, bonuses, counters and random state of running level
+	virtual QByteArray saveState() const;
+	inline virtual quint64 seed() const { return this->oRandom.seedValue(); }
+	// restarts the random sequence, call before starting a game to replay it
+	inline virtual void setSeed(const quint64 uxSeed) { this->oRandom.seed(uxSeed); }
+	// record game that is about to start to pDevice, see Replay
+	virtual bool startRecording(QIODevice *pDevice);
+	virtual void stopRecording();
+	inline virtual QVector<Worm *> worms() const { return this->apWorms; }
 
 signals:
-	void advanceWormTo(Worm *pWorm, const QPoint oPoint) const;
-	void bonusPlaced(const QVector<QPoint> aoPoints, const quint8 ubBonus, const bool bFake);
 	void doGameOver(const QString &sRanking) const;
 	void doLevelDone() const;
 	void doLevelIsMissingSpawnPoints(const quint8 ubMissing) const;
 	void doLevelLoadError() const;
 	void doLevelStartCountdown() const;
 	void debugMessage(const QString &sMessage) const;
-	void move() const;
 	void newHistoryItem(HistoryItem *pHI) const;
 	void loadLevel(MapGame *pMap, const quint8 ubLevel);
-	void spawnWorm(Worm *pWorm) const;
 	void statusMessage(const QString &sMessage) const;
+	// see MapGame::tilesChanged(), once per tick. Connect before a level
+	// loads, see attachMap()
+	void tilesChanged(const QVector<TileChange> &aoChanges) const;
 	void updateHistory() const;
 	void wormAteBonus(Worm *pWorm) const;
 	void wormCrashed(Worm *pWorm) const;
@@ -113,8 +208,8 @@ signals:
 	void wormsInvalidated() const;
 
 public slots:
-	void onBonusPlaced(const QVector<SurfaceCell *> apCells, const bool bFake);
-	void onBonusTimedOut(Bonus *pBonus);
+	void onBonusPlaced(const QVector<QPoint> aoPoints, const quint8 ubBonus,
+					   const bool bFake);
 
 	inline void onDebugMessage(const QString &sMessage) const {
 		Q_EMIT this->debugMessage("G:" + sMessage); }
@@ -129,7 +224,6 @@ public slots:
 	void onResetSoft();
 	void onSpeedChanged(const int iIndex);
 	void onStartNewGame(const quint8 ubLevel);
-	void onTileChanged(const QPoint oPoint, const quint8 ubState);
 	void onWormDied(const bool bAI);
 	inline void onWormFarted() const { }
 
@@ -0,0 +1,427 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "GameHeadless.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+GameHeadless::GameHeadless(QObject *pParent) :
+	Game(pParent),
+	bAborted(false),
+	bDiverged(false),
+	bDone(false),
+	bReplayBonusLeft(false),
+	bReplayEnded(false),
+	bTimedOut(false),
+	bWon(false),
+	ulReplayTicksLeft(0u),
+	ulTicks(0u),
+	ulTicksMax(0u),
+	pReplayPlaying(nullptr) {
+
+	this->apResults.clear();
+	this->hSettings.clear();
+	// whoever drives a headless game decides what to record
+	this->setSetting(AppSettings::sSettingGameRecordReplays, false);
+	this->setSetting(AppSettings::sSettingGameReplayKeyframeTicks,
+					 uint(AppSettings::uiSettingGameReplayKeyframeTicksDefault));
+
+	// never started, they only hold the intervals that playGame() steps by.
+	// Replays skip init() but still pass through onSpeedChanged()
+	this->createTimers();
+
+	connect(this, SIGNAL(doLevelLoadError()),
+			this, SLOT(onAborted()));
+
+	connect(this, SIGNAL(doLevelIsMissingSpawnPoints(quint8)),
+			this, SLOT(onAborted()));
+
+} // construct
+
+
+GameHeadless::~GameHeadless() {
+
+	this->clearResults();
+
+} // dealloc
+
+
+bool GameHeadless::advanceReplay(const quint32 ulTick) {
+
+	if (nullptr == this->pReplayPlaying) return false;
+
+	quint8 ubWorm;
+	quint32 ulValue;
+	Replay::Token eToken;
+	while (!this->bDone && !this->bReplayEnded) {
+
+		if (this->ulReplayTicksLeft) {
+
+			if (ulTick <= this->ulTicks) break;
+
+			this->ensureLevelStarted();
+			if (this->bDone) break;
+
+			this->onTick();
+			this->ulTicks++;
+			this->ulReplayTicksLeft--;
+
+			continue;
+
+		} // if ticks left of last token
+
+		if (this->bReplayBonusLeft) {
+
+			this->bReplayBonusLeft = false;
+
+			this->ensureLevelStarted();
+			if (this->bDone) {
+
+				// no level to place bonus on
+				this->bDiverged = true;
+				break;
+
+			} // if game over
+
+			this->onTickBonus();
+
+			continue;
+
+		} // if bonus tick left of last token
+
+		// bonus ticks right after the last tick still belong to it, so
+		// seeking gives the same state as a keyframe would
+		if (ulTick <= this->ulTicks) {
+
+			if (!this->pReplayPlaying->peekToken(eToken, ulValue)) break;
+			if ((Replay::TicksThenBonus != eToken) || ulValue) break;
+
+		} // if there
+
+		if (!this->pReplayPlaying->nextToken(eToken, ulValue)) {
+
+			this->bReplayEnded = true;
+			break;
+
+		} // if no more tokens
+
+		switch (eToken) {
+
+			case Replay::Ticks:
+				this->ulReplayTicksLeft = ulValue;
+			break;
+
+			case Replay::TicksThenBonus:
+				this->ulReplayTicksLeft = ulValue;
+				this->bReplayBonusLeft = true;
+			break;
+
+			case Replay::Heading:
+
+				this->ensureLevelStarted();
+				if (this->bDone) {
+
+					this->bDiverged = true;
+					break;
+
+				} // if game over
+
+				ubWorm = quint8(ulValue >> 2);
+				if (Replay::ubWormAIEffort == ubWorm)
+					this->eAIEffort = WormAI::Effort(ulValue & 3u);
+				else if (ubWorm < this->apWorms.length())
+					this->apWorms.at(ubWorm)->setHeading(
+								L::Heading(L::North + (ulValue & 3u)));
+
+			break;
+
+			case Replay::End:
+				this->bReplayEnded = true;
+			break;
+
+		} // switch eToken
+
+	} // loop until there or game over
+
+	// timers stop at game over, so nothing but the end marker may follow
+	if (this->bDone && !this->bReplayEnded) {
+
+		if (this->ulReplayTicksLeft || this->bReplayBonusLeft) this->bDiverged = true;
+		else if (this->pReplayPlaying->nextToken(eToken, ulValue)
+				 && (Replay::End != eToken)) this->bDiverged = true;
+
+		this->bReplayEnded = true;
+
+	} // if game over
+
+	return !this->bAborted;
+
+} // advanceReplay
+
+
+void GameHeadless::clearResults() {
+
+	HistoryItem *pHI;
+	while (this->apResults.length()) {
+
+		pHI = this->apResults.takeLast();
+		delete pHI;
+
+	} // loop this->apResults.length()
+
+} // clearResults
+
+
+void GameHeadless::ensureLevelStarted() {
+
+	if (this->bLevelStarted) return;
+
+	this->onNextLevel();
+	if (this->bDone) return;
+
+	this->startLevel();
+
+} // ensureLevelStarted
+
+
+void GameHeadless::gameDone(const bool bGameWon) {
+
+	// may be called again by worms dying in same tick
+	if (this->bDone) return;
+
+	this->bDone = true;
+	this->bWon = bGameWon;
+
+	this->clearResults();
+
+	// unlike Game we record AI results too
+	QVector<Worm *> apRanks = this->makeRanking();
+
+	Worm *pWorm;
+	for (int i = 0; i < apRanks.length(); ++i) {
+
+		pWorm = apRanks.at(i);
+
+		this->apResults.append(
+					new HistoryItem(
+						this->bUseFakes,
+						pWorm->name(),
+						this->ubCountAllPlayers - this->ubCountHumans,
+						this->ubCountHumans, pWorm->levelCount(),
+						this->ubStartLevel, pWorm->livesLost(),
+						this->ubSpeedIndex, pWorm->score(), 0, this));
+
+	} // loop worms sorted by rank
+
+	Game::gameDone(bGameWon);
+
+} // gameDone
+
+
+QString GameHeadless::levelFilePath(const quint8 ubLevel) {
+
+	if (this->sPathLevels.isEmpty()) return Game::levelFilePath(ubLevel);
+
+	return this->sPathLevels + "Level_" + QString::number(ubLevel);
+
+} // levelFilePath
+
+
+bool GameHeadless::playGame(const quint8 ubLevel) {
+
+	this->resetFlags();
+	this->pReplayPlaying = nullptr;
+
+	this->onStartNewGame(ubLevel);
+	if (this->bDone) return !this->bAborted;
+
+	this->startLevel();
+
+	// virtual clock in ms to interleave bonus ticks like the timers would
+	quint64 uxClock = 0u;
+	quint64 uxClockBonus = 0u;
+
+	while (!this->bDone) {
+
+		this->ensureLevelStarted();
+		if (this->bDone) break;
+
+		if (this->ulTicksMax && (this->ulTicksMax <= this->ulTicks)) {
+
+			this->bTimedOut = true;
+			this->gameDone(false);
+
+			break;
+
+		} // if stalled
+
+		uxClock += quint64(this->pTimer->interval());
+		while (uxClockBonus + quint64(this->pTimerBonus->interval()) <= uxClock) {
+
+			uxClockBonus += quint64(this->pTimerBonus->interval());
+			this->onTickBonus();
+
+		} // loop bonus ticks due
+
+		this->onTick();
+		this->ulTicks++;
+
+	} // loop until game over
+
+	return !this->bAborted;
+
+} // playGame
+
+
+bool GameHeadless::openReplay(Replay *pReplay) {
+
+	this->resetFlags();
+	this->pReplayPlaying = pReplay;
+
+	QHash<QString, QVariant> hReplay = pReplay->settings();
+	QHash<QString, QVariant>::const_iterator i;
+	for (i = hReplay.constBegin(); i != hReplay.constEnd(); ++i)
+		this->setSetting(i.key(), i.value());
+
+	quint32 aulState[4];
+	pReplay->randomState(aulState);
+	pReplay->rewind();
+
+	// onStartNewGame does not draw random numbers before recording starts
+	this->oRandom.setState(aulState);
+	this->onStartNewGame(pReplay->level());
+	if (this->bDone) return !this->bAborted;
+
+	this->startLevel();
+
+	return !this->bAborted;
+
+} // openReplay
+
+
+bool GameHeadless::playReplay(Replay *pReplay) {
+
+	if (!this->openReplay(pReplay)) return false;
+
+	return this->advanceReplay(0xFFFFFFFFu);
+
+} // playReplay
+
+
+quint8 GameHeadless::playerColour(const quint8 ubWorm) const {
+
+	QList<QVariant> aColours = this->hSettings.value(
+								   AppSettings::sSettingGameColours).toList();
+
+	return quint8(aColours.value(ubWorm, uint(ubWorm)).toUInt());
+
+} // playerColour
+
+
+void GameHeadless::resetFlags() {
+
+	this->bAborted = false;
+	this->bDiverged = false;
+	this->bDone = false;
+	this->bReplayBonusLeft = false;
+	this->bReplayEnded = false;
+	this->bTimedOut = false;
+	this->bWon = false;
+	this->ulReplayTicksLeft = 0u;
+	this->ulTicks = 0u;
+	this->clearResults();
+
+} // resetFlags
+
+
+bool GameHeadless::restoreKeyframe(const int iIndex) {
+
+	QByteArray aState;
+	if (!this->pReplayPlaying->seekKeyframe(iIndex, aState)) return false;
+
+	this->resetFlags();
+
+	if (!this->restoreState(aState)) {
+
+		this->onAborted();
+
+		return false;
+
+	} // if state does not fit this game
+
+	this->ulTicks = this->pReplayPlaying->keyframeTick(iIndex);
+
+	return true;
+
+} // restoreKeyframe
+
+
+bool GameHeadless::seekReplay(const quint32 ulTick) {
+
+	if (nullptr == this->pReplayPlaying) return false;
+
+	const int iKeyframe = this->pReplayPlaying->keyframeFor(ulTick);
+	const quint32 ulTickKeyframe = (0 <= iKeyframe)
+								   ? this->pReplayPlaying->keyframeTick(iKeyframe) : 0u;
+
+	// playing on from here is no longer than from the keyframe
+	if (!this->bAborted && (ulTickKeyframe <= this->ulTicks)
+			&& (this->ulTicks <= ulTick)) return this->advanceReplay(ulTick);
+
+	if (0 > iKeyframe) {
+
+		if (!this->openReplay(this->pReplayPlaying)) return false;
+
+	} else if (!this->restoreKeyframe(iKeyframe)) {
+
+		// broken keyframe, take the long way
+		if (!this->openReplay(this->pReplayPlaying)) return false;
+
+	} // if no keyframe
+
+	return this->advanceReplay(ulTick);
+
+} // seekReplay
+
+
+QVariant GameHeadless::setting(const QString sKey) const {
+
+	if (this->hSettings.contains(sKey)) return this->hSettings.value(sKey);
+
+	return Game::setting(sKey);
+
+} // setting
+
+
+void GameHeadless::startLevel() {
+
+	// first toggle prepares the level, the second is what the
+	// count-down would send when it is done
+	this->onPauseResumeToggled();
+	if (this->bDone) return;
+
+	this->onPauseResumeToggled();
+
+} // startLevel
+
+
+
+}	} // namespace SwissalpS::QtNibblers
@@ -0,0 +1,122 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GAMEHEADLESS_H
+#define GAMEHEADLESS_H
+
+#include <QObject>
+#include "Game.h"
+#include "HistoryItem.h"
+#include "Replay.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// Game without timers, sound or surface. Ticks are driven by playGame()
+// as fast as possible while keeping the tick to bonus-tick ratio of the
+// selected speed index.
+class GameHeadless : public SwissalpS::QtNibblers::Game {
+
+	Q_OBJECT
+
+private:
+
+protected:
+	bool bAborted;
+	bool bDiverged;
+	bool bDone;
+	bool bReplayBonusLeft;
+	bool bReplayEnded;
+	bool bTimedOut;
+	bool bWon;
+	quint32 ulReplayTicksLeft;
+	quint32 ulTicks;
+	quint32 ulTicksMax;
+	// set by openReplay(), not owned
+	Replay *pReplayPlaying;
+	QString sPathLevels;
+	QHash<QString, QVariant> hSettings;
+	QVector<HistoryItem *> apResults;
+
+	virtual void clearResults();
+	// loads and starts next level if the current one is done
+	virtual void ensureLevelStarted();
+	virtual void gameDone(const bool bGameWon) override;
+	inline virtual bool isReplaying() const override {
+		return nullptr != this->pReplayPlaying; }
+
+	virtual QString levelFilePath(const quint8 ubLevel) override;
+	inline virtual void playFx(const Fx::Sounds eSound) const override { Q_UNUSED(eSound) }
+	// colours setting if set, else every worm gets its own colour
+	virtual quint8 playerColour(const quint8 ubWorm) const override;
+	virtual void resetFlags();
+	// continues replay from keyframe iIndex
+	virtual bool restoreKeyframe(const int iIndex);
+	virtual QVariant setting(const QString sKey) const override;
+	virtual void startLevel();
+	inline virtual void startTimers() override {}
+	inline virtual void stopTimers() override {}
+
+protected slots:
+	inline void onAborted() { this->bAborted = this->bDone = true; }
+
+public:
+	explicit GameHeadless(QObject *pParent = nullptr);
+	virtual ~GameHeadless() override;
+
+	// plays replay opened with openReplay() on until ulTick ticks have run
+	// or it ends, whichever comes first. Returns false if aborted
+	virtual bool advanceReplay(const quint32 ulTick);
+	inline virtual bool isAborted() const { return this->bAborted; }
+	// replay still had input when game ended or vice versa
+	inline virtual bool isDiverged() const { return this->bDiverged; }
+	inline virtual bool isDone() const { return this->bDone; }
+	inline virtual bool isTimedOut() const { return this->bTimedOut; }
+	inline virtual bool isWon() const { return this->bWon; }
+	// starts pReplay at tick 0, see advanceReplay() and seekReplay()
+	virtual bool openReplay(Replay *pReplay);
+	// plays one game from ubLevel until game over, returns false if aborted
+	virtual bool playGame(const quint8 ubLevel);
+	// plays a recorded game, returns false if aborted
+	virtual bool playReplay(Replay *pReplay);
+	// one entry per worm, ordered by rank
+	inline virtual QVector<HistoryItem *> results() const { return this->apResults; }
+	// jumps to ulTick of opened replay, either way. Restores nearest keyframe
+	// unless current tick is closer, then plays on from there.
+	virtual bool seekReplay(const quint32 ulTick);
+	// directory containing Level_N files, empty for the default data path
+	inline virtual void setLevelPath(const QString sPath) { this->sPathLevels = sPath; }
+	// overrides AppSettings for this game only. Set all keys Game reads
+	// when playing from a thread other than the main thread.
+	inline virtual void setSetting(const QString &sKey, const QVariant &mValue) {
+		this->hSettings.insert(sKey, mValue); }
+
+	inline virtual void setTicksMax(const quint32 ulTicks) { this->ulTicksMax = ulTicks; }
+	inline virtual quint32 ticks() const { return this->ulTicks; }
+
+}; // GameHeadless
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // GAMEHEADLESS_H
@@ -566,13 +566,8 @@ void IconEngine::removeCacheOfLevel(const quint8 ubLevel) {
 // static
 QVector<quint8> IconEngine::statesTeleporterEntrances() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubCount;
-	for (ubCount = L::TeleporterInA; ubCount <= L::TeleporterInJ; ubCount += 2u)
-		aStates.append(ubCount);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::TeleporterInA,
+																   L::TeleporterInJ, 2u);
 
 	return aStates;
 
@@ -582,13 +577,8 @@ QVector<quint8> IconEngine::statesTeleporterEntrances() {
 // static
 QVector<quint8> IconEngine::statesTeleporterExits() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubCount;
-	for (ubCount = L::TeleporterOutA; ubCount <= L::TeleporterOutJ; ubCount += 2u)
-		aStates.append(ubCount);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::TeleporterOutA,
+																   L::TeleporterOutJ, 2u);
 
 	return aStates;
 
@@ -598,13 +588,7 @@ QVector<quint8> IconEngine::statesTeleporterExits() {
 // static
 QVector<quint8> IconEngine::statesFloors() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubCount;
-	for (ubCount = L::FloorClean; ubCount <= L::FloorWet9; ++ubCount)
-		aStates.append(ubCount);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::FloorClean, L::FloorWet9);
 
 	return aStates;
 
@@ -614,13 +598,7 @@ QVector<quint8> IconEngine::statesFloors() {
 // static
 QVector<quint8> IconEngine::statesFloorsWet() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubCount;
-	for (ubCount = L::FloorWet1; ubCount <= L::FloorWet9; ++ubCount)
-		aStates.append(ubCount);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::FloorWet1, L::FloorWet9);
 
 	return aStates;
 
@@ -630,17 +608,25 @@ QVector<quint8> IconEngine::statesFloorsWet() {
 // static
 QVector<quint8> IconEngine::statesPickups() {
 
-	static QVector<quint8> aStates;
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::BonusApple, 149u);
+
+	return aStates;
+
+} // statesPickups
+
 
-	if (!aStates.empty()) return aStates;
+// static
+QVector<quint8> IconEngine::statesRange(const quint8 ubFirst, const quint8 ubLast,
+										const quint8 ubStep) {
+
+	QVector<quint8> aStates;
 
-	quint8 ubCount;
-	for (ubCount = L::BonusApple; ubCount < 150u; ++ubCount)
-		aStates.append(ubCount);
+	for (uint uiState = ubFirst; uiState <= ubLast; uiState += ubStep)
+		aStates.append(quint8(uiState));
 
 	return aStates;
 
-} // statesPickups
+} // statesRange
 
 
 // static
@@ -661,15 +647,7 @@ QVector<quint8> IconEngine::statesSnake(const quint8 ubSnake) {
 // static
 QVector<quint8> IconEngine::statesSnakes() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubState = L::Player_1_Head;
-	quint8 ubLast = L::Player_8_Tail;
-
-	for (; ubState <= ubLast; ++ubState)
-		aStates.append(ubState);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::Player_1_Head, L::Player_8_Tail);
 
 	return aStates;
 
@@ -679,13 +657,7 @@ QVector<quint8> IconEngine::statesSnakes() {
 // static
 QVector<quint8> IconEngine::statesSpawns() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubCount;
-	for (ubCount = L::SpawnHeadingNorth; ubCount <= L::SpawnHeadingEast; ++ubCount)
-		aStates.append(ubCount);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::SpawnHeadingNorth, L::SpawnHeadingEast);
 
 	return aStates;
 
@@ -695,13 +667,7 @@ QVector<quint8> IconEngine::statesSpawns() {
 // static
 QVector<quint8> IconEngine::statesWalls() {
 
-	static QVector<quint8> aStates;
-
-	if (!aStates.empty()) return aStates;
-
-	quint8 ubCount;
-	for (ubCount = L::WallVertical; ubCount <= L::WallCross; ++ubCount)
-		aStates.append(ubCount);
+	static const QVector<quint8> aStates = IconEngine::statesRange(L::WallVertical, L::WallCross);
 
 	return aStates;
 
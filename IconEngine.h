@@ -72,6 +72,9 @@ public:
 	static QVector<quint8> statesFloors();
 	static QVector<quint8> statesFloorsWet();
 	static QVector<quint8> statesPickups();
+	// ubFirst to ubLast inclusive
+	static QVector<quint8> statesRange(const quint8 ubFirst, const quint8 ubLast,
+									   const quint8 ubStep = 1u);
 	static QVector<quint8> statesSnake(const quint8 ubSnake);
 	static QVector<quint8> statesSnakes();
 	static QVector<quint8> statesSpawns();
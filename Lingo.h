@@ -251,6 +251,57 @@ public:
 	};
 	Q_ENUM(Tiles)
 
+	// bits of tileClass(), a tile may be in more than one
+	enum TileClass {
+		ClassNone = 0x00u,
+		ClassFloor = 0x01u,
+		ClassFloorWet = 0x02u,
+		ClassSnake = 0x04u,
+		ClassWall = 0x08u,
+		ClassPickup = 0x10u,
+		ClassTeleporterIn = 0x20u,
+		ClassTeleporterOut = 0x40u,
+		ClassSpawn = 0x80u,
+
+		// worms crash into these
+		ClassSolid = ClassSnake | ClassWall,
+		// bonuses may be placed on these
+		ClassFreeForBonus = ClassFloor | ClassTeleporterOut | ClassSpawn
+	};
+
+
+	// true if ubState is in any of ubClasses, see TileClass
+	inline static bool isTile(const quint8 ubState, const quint8 ubClasses) {
+
+		return 0u != (L::tileClass(ubState) & ubClasses);
+
+	} // isTile
+
+
+	// table lookup of tileClassOf()
+	inline static quint8 tileClass(const quint8 ubState);
+
+
+	// same ranges as IconEngine::states*(), evaluated at compile time
+	constexpr static quint8 tileClassOf(const quint8 ubState) {
+
+		return quint8(((FloorWet9 >= ubState) ? ClassFloor : ClassNone)
+					  | (((FloorWet1 <= ubState) && (FloorWet9 >= ubState))
+						 ? ClassFloorWet : ClassNone)
+					  | (((Player_1_Head <= ubState) && (Player_8_Tail >= ubState))
+						 ? ClassSnake : ClassNone)
+					  | (((SpawnHeadingNorth <= ubState) && (SpawnHeadingEast >= ubState))
+						 ? ClassSpawn : ClassNone)
+					  | (((BonusApple <= ubState) && (149u >= ubState))
+						 ? ClassPickup : ClassNone)
+					  | (((WallVertical <= ubState) && (WallCross >= ubState))
+						 ? ClassWall : ClassNone)
+					  | (((TeleporterInA <= ubState) && (TeleporterOutJ >= ubState))
+						 ? ((ubState & 1u) ? ClassTeleporterOut : ClassTeleporterIn)
+						 : ClassNone));
+
+	} // tileClassOf
+
 
 	inline static Heading headingOfUint(const quint8 ubDirection) {
 		switch (ubDirection) {
@@ -391,6 +442,33 @@ public:
 
 
 
+// built here, tileClassOf() can not be called while L is incomplete
+quint8 L::tileClass(const quint8 ubState) {
+
+#define SssS_Nibblers_Tile_Classes_4(u) L::tileClassOf(u), L::tileClassOf(u + 1u), \
+	L::tileClassOf(u + 2u), L::tileClassOf(u + 3u)
+#define SssS_Nibblers_Tile_Classes_16(u) SssS_Nibblers_Tile_Classes_4(u), \
+	SssS_Nibblers_Tile_Classes_4(u + 4u), SssS_Nibblers_Tile_Classes_4(u + 8u), \
+	SssS_Nibblers_Tile_Classes_4(u + 12u)
+#define SssS_Nibblers_Tile_Classes_64(u) SssS_Nibblers_Tile_Classes_16(u), \
+	SssS_Nibblers_Tile_Classes_16(u + 16u), SssS_Nibblers_Tile_Classes_16(u + 32u), \
+	SssS_Nibblers_Tile_Classes_16(u + 48u)
+
+	static constexpr quint8 aubClasses[256] = {
+		SssS_Nibblers_Tile_Classes_64(0u), SssS_Nibblers_Tile_Classes_64(64u),
+		SssS_Nibblers_Tile_Classes_64(128u), SssS_Nibblers_Tile_Classes_64(192u)
+	};
+
+#undef SssS_Nibblers_Tile_Classes_64
+#undef SssS_Nibblers_Tile_Classes_16
+#undef SssS_Nibblers_Tile_Classes_4
+
+	return aubClasses[ubState];
+
+} // L::tileClass
+
+
+
 }	} // namespace SwissalpS::QtNibblers
 
 
@@ -22,6 +22,7 @@
 #include "IconEngine.h"
 #include "SurfaceBuilder.h"
 #include "SurfaceGame.h"
+#include "Trace.h"
 
 #include <iostream>
 #include <QDateTime>
@@ -57,6 +58,9 @@ MainWindow::~MainWindow() {
 	this->pHistory->save();
 	delete this->pHistory;
 
+	if (0 < SssS_Nibblers_Trace_Level)
+		Trace::writeChromeTrace(this->pAS->getDataPath() + "Trace.json");
+
 	this->pAS->sync();
 	this->pAS = nullptr;
 	AppSettings::drop();
@@ -181,12 +185,6 @@ void MainWindow::initGame() {
 			this->pHistory, SLOT(addItem(HistoryItem*)));
 
 
-	connect(pGame, SIGNAL(advanceWormTo(Worm *,QPoint)),
-			pSurface, SLOT(onAdvanceWormTo(Worm *,QPoint)));
-
-	connect(pGame, SIGNAL(bonusPlaced(QVector<QPoint>,quint8,bool)),
-			pSurface, SLOT(onBonusPlaced(QVector<QPoint>,quint8,bool)));
-
 	connect(pGame, SIGNAL(doGameOver(QString)),
 			pSurface, SLOT(onDoGameOver(QString)));
 
@@ -205,15 +203,12 @@ void MainWindow::initGame() {
 	connect(pGame, SIGNAL(loadLevel(MapGame*,quint8)),
 			pSurface, SLOT(onLoadLevel(MapGame*,quint8)));
 
-	connect(pGame, SIGNAL(spawnWorm(Worm*)),
-			pSurface, SLOT(onSpawnWorm(Worm*)));
+	connect(pGame, SIGNAL(tilesChanged(QVector<TileChange>)),
+			pSurface, SLOT(onTilesChanged(QVector<TileChange>)));
 
 	connect(pGame, SIGNAL(wormAteBonus(Worm *)),
 			pSurface, SLOT(onWormAteBonus(Worm *)));
 
-	connect(pGame, SIGNAL(wormCrashed(Worm *)),
-			pSurface, SLOT(onWormCrashed(Worm *)));
-
 	connect(pGame, SIGNAL(wormCreated(Worm *)),
 			pSurface, SLOT(onWormCreated(Worm *)));
 
@@ -221,12 +216,6 @@ void MainWindow::initGame() {
 			pSurface, SLOT(onWormsInvalidated()));
 
 
-	connect(pSurface, SIGNAL(bonusPlaced(QVector<SurfaceCell*>,bool)),
-			pGame, SLOT(onBonusPlaced(QVector<SurfaceCell*>,bool)));
-
-	connect(pSurface, SIGNAL(levelIsLoaded()),
-			pGame, SLOT(onLevelIsLoaded()));
-
 	connect(pSurface, SIGNAL(nextLevel()),
 			pGame, SLOT(onNextLevel()));
 
@@ -236,9 +225,6 @@ void MainWindow::initGame() {
 	connect(pSurface, SIGNAL(startNewGame(quint8)),
 			pGame, SLOT(onStartNewGame(quint8)));
 
-	connect(pSurface, SIGNAL(tileChanged(QPoint,quint8)),
-			pGame, SLOT(onTileChanged(QPoint,quint8)));
-
 	pSurface->init();
 	pGame->init();
 
@@ -17,6 +17,8 @@
  */
 #include "Map.h"
 
+#include <QHash>
+#include <QMutex>
 #include <QPainter>
 #include <QPixmap>
 
@@ -31,7 +33,7 @@ Map::Map(QObject *pParent) :
 	ubTotalColumns(0),
 	ubTotalRows(0) {
 
-	this->aaubRows.clear();
+	this->aubTiles.clear();
 
 } // construct
 
@@ -41,6 +43,7 @@ Map::Map(const quint8 ubColumns, const quint8 ubRows, QObject *pParent) :
 	ubTotalColumns(ubColumns),
 	ubTotalRows(ubRows) {
 
+	this->aiNeighbours = Map::neighbourTable(ubColumns, ubRows);
 	this->fillAll();
 
 } // construct
@@ -48,22 +51,64 @@ Map::Map(const quint8 ubColumns, const quint8 ubRows, QObject *pParent) :
 
 Map::~Map() {
 
-	this->aaubRows.clear();
+	this->aubTiles.clear();
 
 } // dealloc
 
 
 void Map::fillAll(const quint8 ubState) {
 
-	QVector<quint8>aubRow;
-	aubRow.fill(ubState, this->ubTotalColumns);
-
-	this->aaubRows.clear();
-	this->aaubRows.fill(aubRow, this->ubTotalRows);
+	this->aubTiles.fill(ubState, this->cellCount());
 
 } // fillAll
 
 
+// static
+QVector<int> Map::neighbourTable(const quint8 ubColumns, const quint8 ubRows) {
+
+	// maps are created by game threads of nibblers-sim too
+	static QMutex oMutex;
+	static QHash<quint16, QVector<int>> haiTables;
+
+	const quint16 uiKey = quint16(ubColumns << 8) | ubRows;
+
+	QMutexLocker oLocker(&oMutex);
+
+	if (haiTables.contains(uiKey)) return haiTables.value(uiKey);
+
+	QVector<int> aiTable(int(ubColumns) * ubRows * 4);
+
+	int iCell = 0;
+	int iRowAbove;
+	int iRowBelow;
+	for (int iRow = 0; iRow < ubRows; ++iRow) {
+
+		iRowAbove = (0 == iRow) ? ubRows - 1 : iRow - 1;
+		iRowBelow = (ubRows - 1 == iRow) ? 0 : iRow + 1;
+
+		for (int iColumn = 0; iColumn < ubColumns; ++iColumn) {
+
+			// same order as L::North to L::East
+			aiTable[(iCell << 2)] = iRowAbove * ubColumns + iColumn;
+			aiTable[(iCell << 2) + 1] = iRow * ubColumns
+										+ ((0 == iColumn) ? ubColumns - 1 : iColumn - 1);
+			aiTable[(iCell << 2) + 2] = iRowBelow * ubColumns + iColumn;
+			aiTable[(iCell << 2) + 3] = iRow * ubColumns
+										+ ((ubColumns - 1 == iColumn) ? 0 : iColumn + 1);
+
+			++iCell;
+
+		} // loop columns
+
+	} // loop rows
+
+	haiTables.insert(uiKey, aiTable);
+
+	return aiTable;
+
+} // neighbourTable
+
+
 QPixmap Map::pixmap(const bool bSimple) const {
 	Q_UNUSED(bSimple)
 
@@ -82,19 +127,11 @@ QPixmap Map::pixmap(const bool bSimple) const {
 	oP.fillRect(oPixmap.rect(), Qt::black);
 	oP.setPen(Qt::white);
 
-	quint8 ubColumns = 0u;
-	quint8 ubRows = 0u;
+	for (int iCell = 0; iCell < this->cellCount(); ++iCell) {
 
-	for (; ubRows < this->ubTotalRows; ++ubRows) {
-
-		for (ubColumns = 0u; ubColumns < this->ubTotalColumns; ++ubColumns) {
-
-			ubState = this->aaubRows.at(ubRows).at(ubColumns);
-			if (aCOIs.contains(ubState)) oP.drawPoint(ubColumns, ubRows);
-
-		} // loop columns
+		if (aCOIs.contains(this->tileAt(iCell))) oP.drawPoint(this->cellPoint(iCell));
 
-	} // loop rows
+	} // loop cells
 
 	return oPixmap;
 
@@ -103,35 +140,12 @@ QPixmap Map::pixmap(const bool bSimple) const {
 
 void Map::setTile(const quint8 ubColumn, const quint8 ubRow, quint8 ubState) {
 
-	// check limits
-	int iTotalRows = this->aaubRows.length();
-	if (0 == iTotalRows) return;
-	if (ubRow >= iTotalRows) return;
-
-	int iTotalColumns = this->aaubRows.first().length();
-	if (0 == iTotalColumns) return;
-	if (ubColumn >= iTotalColumns) return;
+	if (!this->contains(ubColumn, ubRow)) return;
 
-	this->aaubRows[ubRow][ubColumn] = ubState;
+	this->setTileAt(this->cellIndex(ubColumn, ubRow), ubState);
 
 } // setTile
 
 
-quint8 Map::tile(const quint8 ubColumn, const quint8 ubRow) const {
-
-	// check limits
-	int iTotalRows = this->aaubRows.length();
-	if (0 == iTotalRows) return L::NullTile;
-	if (ubRow >= iTotalRows) return L::NullTile;
-
-	int iTotalColumns = this->aaubRows.first().length();
-	if (0 == iTotalColumns) return L::NullTile;
-	if (ubColumn >= iTotalColumns) return L::NullTile;
-
-	return this->aaubRows.at(ubRow).at(ubColumn);
-
-} // tile
-
-
 
 }	} // namespace SwissalpS::QtNibblers
@@ -19,6 +19,7 @@
 #define MAP_H
 
 #include <QObject>
+#include <QPoint>
 #include <QVector>
 #include "Lingo.h"
 
@@ -37,24 +38,68 @@ private:
 protected:
 	quint8 ubTotalColumns;
 	quint8 ubTotalRows;
-	QVector<QVector<quint8>> aaubRows;
+	// row after row, see cellIndex()
+	QVector<quint8> aubTiles;
+	// 4 cells per cell, see neighbour()
+	QVector<int> aiNeighbours;
 
 public:
 	explicit Map(QObject *pParent = nullptr);
 	explicit Map(const quint8 ubColumns, const quint8 ubRows, QObject *pParent = nullptr);
 	virtual ~Map();
 
+	// valid cell indexes are 0 to cellCount() - 1
+	inline int cellCount() const { return int(this->ubTotalColumns) * this->ubTotalRows; }
+	inline int cellIndex(const quint8 ubColumn, const quint8 ubRow) const {
+		return int(ubRow) * this->ubTotalColumns + ubColumn; }
+
+	inline int cellIndex(const QPoint oPoint) const {
+		return oPoint.y() * this->ubTotalColumns + oPoint.x(); }
+
+	inline QPoint cellPoint(const int iCell) const {
+		return QPoint(iCell % this->ubTotalColumns, iCell / this->ubTotalColumns); }
+
+	inline quint8 columns() const { return this->ubTotalColumns; }
+	inline bool contains(const quint8 ubColumn, const quint8 ubRow) const {
+		return (this->ubTotalColumns > ubColumn) && (this->ubTotalRows > ubRow); }
+
 	inline bool isNull() { return (0 == this->ubTotalColumns) || (0 == this->ubTotalRows); }
 	virtual void fillAll(const quint8 ubState = L::FloorClean);
+	// cell next to iCell going eHeading (North to East), wrapping around
+	// the edges. Unchecked, iCell must be valid.
+	inline int neighbour(const int iCell, const L::Heading eHeading) const {
+		return this->aiNeighbours.constData()[(iCell << 2) + (eHeading - L::North)]; }
+
+	// like L::warpPoint() but looked up, QPoint() when oPoint is outside
+	inline QPoint neighbourPoint(const QPoint oPoint, const L::Heading eHeading) const {
+		if (!this->contains(quint8(oPoint.x()), quint8(oPoint.y()))) return QPoint();
+		if ((L::North > eHeading) || (L::East < eHeading)) return oPoint;
+		return this->cellPoint(this->neighbour(this->cellIndex(oPoint), eHeading)); }
+
+	// North, West, South and East neighbour of every cell of a board this
+	// size. Built once per size and shared. Teleporters are not included.
+	static QVector<int> neighbourTable(const quint8 ubColumns, const quint8 ubRows);
 	virtual QPixmap pixmap(const bool bSimple = true) const;
+	inline quint8 rows() const { return this->ubTotalRows; }
 	virtual void setTile(const quint8 ubColumn, const quint8 ubRow, quint8 ubState);
 	inline virtual void setTile(const QPoint oPoint, quint8 ubState) {
 		this->setTile(quint8(oPoint.x()), quint8(oPoint.y()), ubState); }
 
-	virtual quint8 tile(const quint8 ubColumn, const quint8 ubRow) const;
-	inline virtual quint8 tile(const QPoint oPoint) const {
+	// unchecked and without notifying subclasses, for maps nobody watches
+	inline void setTileAt(const int iCell, const quint8 ubState) {
+		this->aubTiles.data()[iCell] = ubState; }
+
+	// L::NullTile when outside
+	inline quint8 tile(const quint8 ubColumn, const quint8 ubRow) const {
+		return this->contains(ubColumn, ubRow)
+				? this->tileAt(this->cellIndex(ubColumn, ubRow)) : quint8(L::NullTile); }
+
+	inline quint8 tile(const QPoint oPoint) const {
 		return this->tile(quint8(oPoint.x()), quint8(oPoint.y())); }
 
+	// unchecked, iCell must be valid
+	inline quint8 tileAt(const int iCell) const { return this->aubTiles.constData()[iCell]; }
+
 signals:
 	void debugMessage(const QString &sMessage) const;
 
@@ -18,7 +18,6 @@
 #include "MapGame.h"
 
 #include "definitions.h"
-#include "IconEngine.h"
 
 #include <QFileInfo>
 
@@ -30,14 +29,25 @@ namespace SwissalpS { namespace QtNibblers {
 
 MapGame::MapGame(QObject *pParent) :
 	Map(pParent),
-	eErrorCode(NullObject) {
+	eErrorCode(NullObject),
+	bRegionsValid(false),
+	bRegionsFull(true),
+	bTileChangesWanted(true),
+	iTileChangesDepth(0),
+	uiRegionsPass(0u) {
 
 } // construct(null-object)
 
 
 MapGame::MapGame(const QByteArray &aFileContents, QObject *pParent) :
 	Map(SssS_Nibblers_Surface_Width, SssS_Nibblers_Surface_Height, pParent),
-	eErrorCode(NoError) {
+	eErrorCode(NoError),
+	oFree(SssS_Nibblers_Surface_Width, SssS_Nibblers_Surface_Height),
+	bRegionsValid(false),
+	bRegionsFull(true),
+	bTileChangesWanted(true),
+	iTileChangesDepth(0),
+	uiRegionsPass(0u) {
 
 	if ((SssS_Nibblers_Surface_Height * SssS_Nibblers_Surface_Width)
 			> aFileContents.length()) {
@@ -49,44 +59,48 @@ MapGame::MapGame(const QByteArray &aFileContents, QObject *pParent) :
 
 	} // if invalid length
 
-	QVector<quint8> aStatesSpawns = IconEngine::statesSpawns();
-	QVector<quint8> aStatesTeleporterEntrances = IconEngine::statesTeleporterEntrances();
-	QVector<quint8> aStatesTeleporterExits = IconEngine::statesTeleporterExits();
-
-	int iPos = 0;
-	quint8 ubColumns = 0u;
-	quint8 ubRows = 0u;
 	quint8 ubState = L::FloorClean;
 
-	for (; ubRows < SssS_Nibblers_Surface_Height; ++ubRows) {
+	// file is laid out row after row just like the tiles
+	for (int iCell = 0; iCell < this->cellCount(); ++iCell) {
 
-		for (ubColumns = 0u; ubColumns < SssS_Nibblers_Surface_Width; ++ubColumns) {
+		ubState = quint8(aFileContents.at(iCell));
 
-			ubState = quint8(aFileContents.at(iPos));
+		// keep track of special ones
 
-			// keep track of special ones
+		if (L::isTile(ubState, L::ClassSpawn)) {
 
-			if (aStatesSpawns.contains(ubState)) {
+			this->aPointsSpawn.append(this->cellPoint(iCell));
 
-				this->aPointsSpawn.append(QPoint(ubColumns, ubRows));
+		} else if (L::isTile(ubState, L::ClassTeleporterIn)) {
 
-			} else if (aStatesTeleporterEntrances.contains(ubState)) {
+			this->hPointsTeleporterIn.insert(ubState, this->cellPoint(iCell));
 
-				this->hPointsTeleporterIn.insert(ubState, QPoint(ubColumns, ubRows));
+		} else if (L::isTile(ubState, L::ClassTeleporterOut)) {
 
-			} else if (aStatesTeleporterExits.contains(ubState)) {
+			this->hPointsTeleporterOut.insert(ubState, this->cellPoint(iCell));
 
-				this->hPointsTeleporterOut.insert(ubState, QPoint(ubColumns, ubRows));
+		} // if special state we need to keep track of (new state)
 
-			} // if special state we need to keep track of (new state)
+		// nobody is connected yet
+		this->setTileAt(iCell, ubState);
+		this->oFree.setAt(iCell, !L::isTile(ubState, L::ClassSolid));
 
-			this->setTile(ubColumns, ubRows, ubState);
+	} // loop cells
 
-			iPos++;
+	// remember original states
+	this->aubTilesFrozen = this->aubTiles;
 
-		} // loop columns
+	// nothing known about straight lines yet
+	this->aubLines.fill(0u, this->cellCount());
+	this->abRowsStale.fill(true, this->ubTotalRows);
+	this->abColumnsStale.fill(true, this->ubTotalColumns);
 
-	} // loop rows
+	// from here on kept in step with every tile change
+	this->aiBonusSpotIndex.fill(-1, this->cellCount());
+	for (int iRow = 0; iRow < this->ubTotalRows; ++iRow)
+		for (int iColumn = 0; iColumn < this->ubTotalColumns; ++iColumn)
+			this->updateBonusSpot(iColumn, iRow);
 
 } // construct
 
@@ -96,131 +110,255 @@ MapGame::~MapGame() {
 	this->aPointsSpawn.clear();
 	this->hPointsTeleporterIn.clear();
 	this->hPointsTeleporterOut.clear();
+	this->aubTilesFrozen.clear();
 
 } // dealloc
 
 
-QVector<QPoint> MapGame::freeSpotForBonus() {
+void MapGame::beginTileChanges() {
 
-	//this->onDebugMessage("freeSpotForBonus");
+	this->iTileChangesDepth++;
 
-	// find 4 adjacent cells that are not occupied
+} // beginTileChanges
 
-	QPoint oPoint;
-	QVector<QPoint> aoPoints;
-	static QVector<QPoint> aoFreePoints;
 
-	if (aoFreePoints.isEmpty()) {
+void MapGame::defrostTile(const QPoint oPoint, const bool bTrail) {
 
-		quint8 ubColumns = 0u;
-		quint8 ubRows = 0u;
+	// check limits
+	if ((0 > oPoint.x()) || (this->ubTotalColumns <= oPoint.x())) return;
+	if ((0 > oPoint.y()) || (this->ubTotalRows <= oPoint.y())) return;
 
-		for (; ubRows < SssS_Nibblers_Surface_Height - 1u; ++ubRows) {
+	const int iCell = this->cellIndex(oPoint);
+	const quint8 ubOld = this->tileAt(iCell);
+	quint8 ubState = this->aubTilesFrozen.at(iCell);
 
-			for (ubColumns = 0u; ubColumns < SssS_Nibblers_Surface_Width - 1u; ++ubColumns) {
+	// nothing to do?
+	if (ubState == ubOld) return;
 
-				// OK, this one could work
-				oPoint = QPoint(ubColumns, ubRows);
-				if (this->isGoodForBonus(oPoint))
-					aoFreePoints.append(oPoint);
+	const bool bFree = !L::isTile(ubState, L::ClassSolid);
+	if (bFree != this->oFree.at(iCell)) this->markRegionStale(iCell);
 
-			} // loop columns
+	this->setTileAt(iCell, ubState);
+	this->oFree.setAt(iCell, bFree);
+	this->bRegionsValid = false;
+	this->markLinesStale(iCell);
+	this->updateBonusSpots(iCell);
 
-		} // loop rows
+	this->onTileChanged(iCell, ubOld, ubState, bTrail);
 
-	} // first call
+} // defrostTile
 
-	int iMaxPlusOne = aoFreePoints.length();
-	if (0 == iMaxPlusOne) {
 
-		this->onDebugMessage("No Space Found for bonus");
+void MapGame::endTileChanges() {
 
-		return aoPoints;
+	if (0 < --this->iTileChangesDepth) return;
 
-	} // if no free space to put any bonus
+	this->iTileChangesDepth = 0;
 
-	int iIndex;
-	int iMin = 0;
-	QPoint oPoint2;
-	QVector<QPoint> aoTriedPoints;
-	bool bOK = false;
-	while (!bOK) {
+	if (this->aoTileChanges.isEmpty()) return;
 
-		iIndex = iMin + (qrand() % (iMaxPlusOne - iMin));
-		oPoint = aoFreePoints.at(iIndex);
+	Q_EMIT this->tilesChanged(this->aoTileChanges);
 
-		if (aoTriedPoints.contains(oPoint)) continue;
+	// keeps the capacity for the next tick
+	this->aoTileChanges.resize(0);
 
-		if (this->isGoodForBonus(oPoint)) {
+} // endTileChanges
 
-			bOK = true;
-			continue;
 
-		} // if good found
+QVector<QPoint> MapGame::freeSpotForBonus(Random *pRandom) {
 
-		aoTriedPoints.append(oPoint);
+	//this->onDebugMessage("freeSpotForBonus");
 
-		if (aoTriedPoints.length() == aoFreePoints.length()) {
+	QVector<QPoint> aoPoints;
 
-			// tried all but could not satisfy
+	if (this->aiBonusSpots.isEmpty()) {
 
-			this->onDebugMessage("No Space Found for bonus");
+		this->onDebugMessage("No Space Found for bonus");
 
-			return aoPoints;
+		return aoPoints;
 
-		} // if nothing found
+	} // if no free space to put any bonus
 
-	} // loop !bOK
+	// every spot in the list is free, one draw is enough
+	const int iIndex = int(pRandom->bounded(quint32(this->aiBonusSpots.length())));
+	const QPoint oPoint = this->cellPoint(this->aiBonusSpots.at(iIndex));
+	const QPoint oPoint2 = this->neighbourPoint(oPoint, L::Down);
 
 	aoPoints.append(oPoint);
-	aoPoints.append(L::warpPoint(oPoint, L::Right));
-	oPoint2 = L::warpPoint(oPoint, L::Down);
-	aoPoints.append(L::warpPoint(oPoint2, L::Right));
+	aoPoints.append(this->neighbourPoint(oPoint, L::Right));
+	aoPoints.append(this->neighbourPoint(oPoint2, L::Right));
 	aoPoints.append(oPoint2);
 
-//	this->onDebugMessage("\n" + QString::number(aoPoints.at(0).x())
-//						 + ":" + QString::number(aoPoints.at(0).y())
-//						 + " " + QString::number(aoPoints.at(1).x())
-//						 + ":" + QString::number(aoPoints.at(1).y())
-//						 + " " + QString::number(aoPoints.at(2).x())
-//						 + ":" + QString::number(aoPoints.at(2).y())
-//						 + " " + QString::number(aoPoints.at(3).x())
-//						 + ":" + QString::number(aoPoints.at(3).y()));
-
 	return aoPoints;
 
 } // freeSpotForBonus
 
 
+quint8 MapGame::frozenTile(const QPoint oPoint) const {
+
+	// check limits
+	if ((0 > oPoint.x()) || (this->ubTotalColumns <= oPoint.x())) return L::NullTile;
+	if ((0 > oPoint.y()) || (this->ubTotalRows <= oPoint.y())) return L::NullTile;
+
+	return this->aubTilesFrozen.at(this->cellIndex(oPoint));
+
+} // frozenTile
+
+
 // check if a bonus can be placed there
 bool MapGame::isGoodForBonus(const QPoint oPoint) {
 
-	static QVector<quint8> aubStatesFree;
-	if (aubStatesFree.isEmpty())
-		aubStatesFree = IconEngine::statesFloors()
-						+ IconEngine::statesTeleporterExits()
-						+ IconEngine::statesSpawns();
-	quint8 ubState;
-	QPoint oPoint2;
+	if (!this->contains(quint8(oPoint.x()), quint8(oPoint.y()))) return false;
 
-	ubState = this->tile(oPoint);
-	if (!aubStatesFree.contains(ubState)) return false;
+	const int iCell = this->cellIndex(oPoint);
+	if (!L::isTile(this->tileAt(iCell), L::ClassFreeForBonus)) return false;
 
-	ubState = this->tile(L::warpPoint(oPoint, L::Right));
-	if (!aubStatesFree.contains(ubState)) return false;
+	if (!L::isTile(this->tileAt(this->neighbour(iCell, L::Right)), L::ClassFreeForBonus))
+		return false;
 
-	oPoint2 = L::warpPoint(oPoint, L::Down);
-	ubState = this->tile(oPoint2);
-	if (!aubStatesFree.contains(ubState)) return false;
+	const int iCellBelow = this->neighbour(iCell, L::Down);
+	if (!L::isTile(this->tileAt(iCellBelow), L::ClassFreeForBonus)) return false;
 
-	ubState = this->tile(L::warpPoint(oPoint2, L::Right));
-	if (!aubStatesFree.contains(ubState)) return false;
+	if (!L::isTile(this->tileAt(this->neighbour(iCellBelow, L::Right)),
+				   L::ClassFreeForBonus))
+		return false;
 
 	return true;
 
 } // isGoodForBonus
 
 
+// union-find over the cells, joining every cell with its east and south
+// neighbour. Regions are named after their lowest cell, so one pass in
+// cell order is enough to resolve the labels.
+void MapGame::labelAllRegions() {
+
+	const int iCells = this->cellCount();
+	int iCell, iOther, iRoot, iRootOther;
+	int i;
+
+	this->aiRegions.fill(-1, iCells);
+	this->aiRegionSizes.fill(0, iCells);
+	this->aubNearHeads.fill(0u, iCells);
+	this->aiRegionsStale.clear();
+	this->bRegionsFull = false;
+
+	int *piRegions = this->aiRegions.data();
+	int *piSizes = this->aiRegionSizes.data();
+	quint8 *pubNear = this->aubNearHeads.data();
+
+	for (i = 0; i < this->aiRegionHeads.length(); ++i) {
+
+		iCell = this->aiRegionHeads.at(i);
+		if ((0 > iCell) || (iCells <= iCell)) continue;
+
+		++pubNear[this->neighbour(iCell, L::North)];
+		++pubNear[this->neighbour(iCell, L::West)];
+		++pubNear[this->neighbour(iCell, L::South)];
+		++pubNear[this->neighbour(iCell, L::East)];
+
+	} // loop heads
+
+	for (iCell = 0; iCell < iCells; ++iCell) {
+
+		if (this->isRegionCell(iCell)) piRegions[iCell] = iCell;
+
+	} // loop cells
+
+	for (iCell = 0; iCell < iCells; ++iCell) {
+
+		if (0 > piRegions[iCell]) continue;
+
+		for (i = 0; i < 2; ++i) {
+
+			iOther = this->neighbour(iCell, (0 == i) ? L::East : L::South);
+			if (0 > piRegions[iOther]) continue;
+
+			// find both roots, halving the paths on the way
+			iRoot = iCell;
+			while (piRegions[iRoot] != iRoot) {
+
+				piRegions[iRoot] = piRegions[piRegions[iRoot]];
+				iRoot = piRegions[iRoot];
+
+			} // loop up
+
+			iRootOther = iOther;
+			while (piRegions[iRootOther] != iRootOther) {
+
+				piRegions[iRootOther] = piRegions[piRegions[iRootOther]];
+				iRootOther = piRegions[iRootOther];
+
+			} // loop up
+
+			if (iRoot < iRootOther) piRegions[iRootOther] = iRoot;
+			else piRegions[iRoot] = iRootOther;
+
+		} // loop east and south
+
+	} // loop cells
+
+	// parents are always lower cells, which are resolved by now
+	for (iCell = 0; iCell < iCells; ++iCell) {
+
+		if (0 > piRegions[iCell]) continue;
+
+		piRegions[iCell] = piRegions[piRegions[iCell]];
+		++piSizes[piRegions[iCell]];
+
+	} // loop cells
+
+} // labelAllRegions
+
+
+// heads that moved free the cells around where they were and block the
+// ones around where they are. Those and the tiles that turned free or
+// solid are all that can split or join regions.
+void MapGame::labelRegions(const QVector<int> aiHeads) {
+
+	const int iCells = this->cellCount();
+	const int iLength = qMax(aiHeads.length(), this->aiRegionHeads.length());
+	int iHead, iHeadOld;
+	int i, k;
+
+	if (iCells != this->aiRegions.length()) this->bRegionsFull = true;
+
+	for (i = 0; (i < iLength) && !this->bRegionsFull; ++i) {
+
+		iHead = (aiHeads.length() > i) ? aiHeads.at(i) : -1;
+		iHeadOld = (this->aiRegionHeads.length() > i) ? this->aiRegionHeads.at(i) : -1;
+		if (iHead == iHeadOld) continue;
+
+		for (k = 0; k < 4; ++k) {
+
+			if ((0 <= iHeadOld) && (iCells > iHeadOld)) {
+
+				--this->aubNearHeads[this->neighbour(iHeadOld, L::Heading(L::North + k))];
+				this->markRegionStale(this->neighbour(iHeadOld, L::Heading(L::North + k)));
+
+			} // if was on the board
+
+			if ((0 <= iHead) && (iCells > iHead)) {
+
+				++this->aubNearHeads[this->neighbour(iHead, L::Heading(L::North + k))];
+				this->markRegionStale(this->neighbour(iHead, L::Heading(L::North + k)));
+
+			} // if is on the board
+
+		} // loop cells around
+
+	} // loop heads
+
+	this->aiRegionHeads = aiHeads;
+
+	if (this->bRegionsFull) this->labelAllRegions();
+	else this->relabelStaleRegions();
+
+	this->bRegionsValid = true;
+
+} // labelRegions
+
+
 // static main way to get a map
 MapGame *MapGame::loadedMap(const QString sFilePath, QObject *pParent) {
 
@@ -261,13 +399,33 @@ MapGame *MapGame::loadedMap(const QString sFilePath, QObject *pParent) {
 } // loadedMap
 
 
-void MapGame::randomizeSpawnOrder() {
+void MapGame::onTileChanged(const int iCell, const quint8 ubOld,
+							const quint8 ubNew, const bool bTrail) {
+
+	if (!this->bTileChangesWanted) return;
+
+	const TileChange oChange = { quint16(iCell), ubOld, ubNew, bTrail };
+
+	if (0 < this->iTileChangesDepth) {
+
+		this->aoTileChanges.append(oChange);
+
+		return;
+
+	} // if collecting
+
+	Q_EMIT this->tilesChanged(QVector<TileChange>() << oChange);
+
+} // onTileChanged
+
+
+void MapGame::randomizeSpawnOrder(Random *pRandom) {
 
 	int iPos;
 	QVector<QPoint> aNew;
 	while(this->aPointsSpawn.length()) {
 
-		iPos = qrand() % this->aPointsSpawn.length();
+		iPos = int(pRandom->bounded(quint32(this->aPointsSpawn.length())));
 		aNew.append(this->aPointsSpawn.takeAt(iPos));
 
 	} // loop all out
@@ -277,6 +435,364 @@ void MapGame::randomizeSpawnOrder() {
 } // randomizeSpawns
 
 
+void MapGame::readState(QDataStream &oStream) {
+
+	quint8 ubColumn;
+	quint8 ubRow;
+	quint8 ubState;
+
+	this->beginTileChanges();
+	for (int iCell = 0; iCell < this->cellCount(); ++iCell) {
+
+		oStream >> ubState;
+		this->setTile(this->cellPoint(iCell), ubState);
+
+	} // loop cells
+	this->endTileChanges();
+
+	quint16 uiCount;
+	oStream >> uiCount;
+
+	// has to be the same spots as setTile() left, only in another order
+	if (this->aiBonusSpots.length() != uiCount) {
+
+		oStream.setStatus(QDataStream::ReadCorruptData);
+
+		return;
+
+	} // if not as many
+
+	int iCell;
+	QVector<int> aiSpots;
+	QVector<bool> abListed(this->cellCount(), false);
+	for (quint16 ui = 0u; ui < uiCount; ++ui) {
+
+		oStream >> ubColumn >> ubRow;
+
+		iCell = this->contains(ubColumn, ubRow)
+				? this->cellIndex(ubColumn, ubRow) : -1;
+
+		if ((0 > iCell) || (0 > this->aiBonusSpotIndex.at(iCell))
+				|| abListed.at(iCell)) {
+
+			oStream.setStatus(QDataStream::ReadCorruptData);
+
+			return;
+
+		} // if not a free block or listed twice
+
+		abListed[iCell] = true;
+		aiSpots.append(iCell);
+
+	} // loop spots
+
+	// in the order random numbers pick from
+	this->aiBonusSpotIndex.fill(-1);
+	this->aiBonusSpots = aiSpots;
+	for (int i = 0; i < aiSpots.length(); ++i)
+		this->aiBonusSpotIndex[aiSpots.at(i)] = i;
+
+} // readState
+
+
+// one pass backwards around the line, twice so that what lies past
+// the wrap is known when the second lap writes the bits. A cell whose
+// next one is cell 0 stops, see WormAI::wander()
+void MapGame::refreshLine(const int iFirst, const L::Heading eHeading) {
+
+	const int iIndex = (eHeading - L::North) & 3;
+	const quint8 ubBit = quint8(1u << iIndex);
+	const L::Heading eBack = L::Heading(L::North + (iIndex ^ 2));
+	const int iLength = ((L::West == eHeading) || (L::East == eHeading))
+						? this->ubTotalColumns : this->ubTotalRows;
+	quint8 *pubLines = this->aubLines.data();
+	// what a walk from the cell after iCell ends with, nothing in the way
+	// on the whole line is a miss too
+	bool bFound = false;
+	int iCell = iFirst;
+	Wander eWander;
+
+	for (int i = 0; i < 2 * iLength; ++i) {
+
+		iCell = this->neighbour(iCell, eBack);
+
+		if (0 == this->neighbour(iCell, eHeading)) eWander = WanderStop;
+		else eWander = wanderTile(this->tileAt(iCell));
+
+		if (WanderOn != eWander) bFound = (WanderFound == eWander);
+
+		if (iLength > i) continue;
+
+		if (bFound) pubLines[iCell] |= ubBit;
+		else pubLines[iCell] &= quint8(~ubBit);
+
+	} // loop cells twice
+
+} // refreshLine
+
+
+void MapGame::refreshLines() {
+
+	int i;
+
+	for (i = 0; i < this->abRowsStale.length(); ++i) {
+
+		if (!this->abRowsStale.at(i)) continue;
+
+		this->refreshLine(this->cellIndex(0u, quint8(i)), L::West);
+		this->refreshLine(this->cellIndex(0u, quint8(i)), L::East);
+		this->abRowsStale[i] = false;
+
+	} // loop rows
+
+	for (i = 0; i < this->abColumnsStale.length(); ++i) {
+
+		if (!this->abColumnsStale.at(i)) continue;
+
+		this->refreshLine(i, L::North);
+		this->refreshLine(i, L::South);
+		this->abColumnsStale[i] = false;
+
+	} // loop columns
+
+} // refreshLines
+
+
+// mirrors what WormAI::deadendAfter() floods: blocked are the cells next
+// to other heads, iNext and iStart. The regions lack the cells next to
+// aiHeads[iSelf] though, so the ones of those still open are joined by
+// hand. Taking iStart out of its region can not cut anything off from
+// the neighbours of iStart, which are where counting starts.
+int MapGame::regionRoom(const QVector<int> &aiHeads, const int iSelf,
+						const int iNext, const int iStart) const {
+
+	if (!this->bRegionsValid || (aiHeads != this->aiRegionHeads)) return -1;
+	if ((0 > iSelf) || (aiHeads.length() <= iSelf)) return -1;
+
+	const int iHead = aiHeads.at(iSelf);
+	if (0 > iHead) return -1;
+
+	const int *piRegions = this->aiRegions.constData();
+	const int *piSizes = this->aiRegionSizes.constData();
+	// cells next to own head that are open, at most 3
+	int aiOpen[4];
+	bool abOpenReached[4];
+	int iOpen = 0;
+	// regions reached, from 4 seeds plus 3 neighbours of each open cell
+	int aiReached[16];
+	int iReached = 0;
+	bool bChanged;
+	int iCell, iRegion, iRoom;
+	int i, j, k;
+
+	for (i = 0; i < aiHeads.length(); ++i) {
+
+		if (i == iSelf) continue;
+
+		// deadendAfter() skips heads on iNext, which we can't
+		if ((aiHeads.at(i) == iHead) || (aiHeads.at(i) == iNext)) return -1;
+		if (0 > aiHeads.at(i)) return -1;
+
+	} // loop other heads
+
+	for (k = 0; k < 4; ++k) {
+
+		iCell = this->neighbour(iHead, L::Heading(L::North + k));
+		if (iCell == iStart) return -1;
+		if (iCell == iNext) continue;
+		if (!this->oFree.at(iCell)) continue;
+
+		for (i = 0; i < aiHeads.length(); ++i) {
+
+			if ((i != iSelf) && this->isNextTo(iCell, aiHeads.at(i))) break;
+
+		} // loop other heads
+
+		if (aiHeads.length() > i) continue;
+
+		aiOpen[iOpen] = iCell;
+		abOpenReached[iOpen] = false;
+		++iOpen;
+
+	} // loop cells around own head
+
+	// seed with the neighbours of iStart, afterwards with the neighbours
+	// of open cells that got reached, until no more open cells join
+	iCell = iStart;
+	do {
+
+		bChanged = false;
+
+		for (k = 0; k < 4; ++k) {
+
+			iRegion = piRegions[this->neighbour(iCell, L::Heading(L::North + k))];
+			if (0 > iRegion) continue;
+
+			for (j = 0; j < iReached; ++j) if (aiReached[j] == iRegion) break;
+			if (iReached == j) aiReached[iReached++] = iRegion;
+
+		} // loop neighbours
+
+		for (i = 0; i < iOpen; ++i) {
+
+			if (abOpenReached[i]) continue;
+
+			for (k = 0; k < 4; ++k) {
+
+				iCell = this->neighbour(aiOpen[i], L::Heading(L::North + k));
+				if (iStart == iCell) break;
+
+				for (j = 0; j < iOpen; ++j) {
+
+					if ((aiOpen[j] == iCell) && abOpenReached[j]) break;
+
+				} // loop open cells
+
+				if (iOpen > j) break;
+
+				iRegion = piRegions[iCell];
+				if (0 > iRegion) continue;
+
+				for (j = 0; j < iReached; ++j) if (aiReached[j] == iRegion) break;
+				if (iReached > j) break;
+
+			} // loop neighbours
+
+			if (4 == k) continue;
+
+			abOpenReached[i] = true;
+			iCell = aiOpen[i];
+			bChanged = true;
+
+			break;
+
+		} // loop open cells
+
+	} while (bChanged);
+
+	iRoom = 0;
+	for (j = 0; j < iReached; ++j) iRoom += piSizes[aiReached[j]];
+	for (i = 0; i < iOpen; ++i) if (abOpenReached[i]) ++iRoom;
+
+	// iStart itself is blocked
+	iRegion = piRegions[iStart];
+	for (j = 0; j < iReached; ++j) if (aiReached[j] == iRegion) --iRoom;
+
+	return iRoom;
+
+} // regionRoom
+
+
+// a region that neither holds nor touches a stale cell kept its cells
+// and what walls them in, so it is still labelled right. All others,
+// split or joined, are flooded from the stale cells and their neighbours.
+void MapGame::relabelStaleRegions() {
+
+	const int iCells = this->cellCount();
+	int *piRegions = this->aiRegions.data();
+	int *piSizes = this->aiRegionSizes.data();
+	QVector<int> aiQueue;
+	int iBegin, iCell, iFlooded, iNext, iOther, iRegion, iRoot;
+	int h, i, j, k;
+
+	if (0 == ++this->uiRegionsPass) {
+
+		this->auiRegionsSeen.fill(0u, iCells);
+		this->uiRegionsPass = 1u;
+
+	} else if (iCells != this->auiRegionsSeen.length())
+		this->auiRegionsSeen.fill(0u, iCells);
+
+	quint32 *puiSeen = this->auiRegionsSeen.data();
+	const quint32 uiPass = this->uiRegionsPass;
+
+	// sizes of the regions about to be flooded go first, as a new region
+	// may well be named after a cell that already named an old one
+	for (i = 0; i < this->aiRegionsStale.length(); ++i) {
+
+		iCell = this->aiRegionsStale.at(i);
+		for (k = -1; k < 4; ++k) {
+
+			iOther = (0 > k) ? iCell : this->neighbour(iCell, L::Heading(L::North + k));
+			iRegion = piRegions[iOther];
+			if (0 <= iRegion) piSizes[iRegion] = 0;
+
+		} // loop cell and neighbours
+
+		if (!this->isRegionCell(iCell)) piRegions[iCell] = -1;
+
+	} // loop stale cells
+
+	aiQueue.reserve(iCells);
+	for (i = 0; i < this->aiRegionsStale.length(); ++i) {
+
+		iCell = this->aiRegionsStale.at(i);
+		for (k = -1; k < 4; ++k) {
+
+			iOther = (0 > k) ? iCell : this->neighbour(iCell, L::Heading(L::North + k));
+			if ((uiPass == puiSeen[iOther]) || !this->isRegionCell(iOther)) continue;
+
+			// breadth first, the queue keeps what it passed for labelling
+			iBegin = aiQueue.length();
+			iRoot = iOther;
+			puiSeen[iOther] = uiPass;
+			aiQueue.append(iOther);
+
+			for (j = iBegin; j < aiQueue.length(); ++j) {
+
+				iFlooded = aiQueue.at(j);
+				if (iRoot > iFlooded) iRoot = iFlooded;
+
+				for (h = 0; h < 4; ++h) {
+
+					iNext = this->neighbour(iFlooded, L::Heading(L::North + h));
+					if ((uiPass == puiSeen[iNext]) || !this->isRegionCell(iNext))
+						continue;
+
+					puiSeen[iNext] = uiPass;
+					aiQueue.append(iNext);
+
+				} // loop neighbours
+
+			} // loop queue
+
+			for (j = iBegin; j < aiQueue.length(); ++j) piRegions[aiQueue.at(j)] = iRoot;
+			piSizes[iRoot] = aiQueue.length() - iBegin;
+
+		} // loop cell and neighbours
+
+	} // loop stale cells
+
+	this->aiRegionsStale.clear();
+
+} // relabelStaleRegions
+
+
+void MapGame::setTile(const quint8 ubColumn, const quint8 ubRow, quint8 ubState) {
+
+	// check limits
+	if (!this->contains(ubColumn, ubRow)) return;
+
+	const int iCell = this->cellIndex(ubColumn, ubRow);
+	const quint8 ubOld = this->tileAt(iCell);
+
+	// nothing to do?
+	if (ubState == ubOld) return;
+
+	const bool bFree = !L::isTile(ubState, L::ClassSolid);
+	if (bFree != this->oFree.at(iCell)) this->markRegionStale(iCell);
+
+	this->setTileAt(iCell, ubState);
+	this->oFree.setAt(iCell, bFree);
+	this->bRegionsValid = false;
+	this->markLinesStale(iCell);
+	this->updateBonusSpots(iCell);
+
+	this->onTileChanged(iCell, ubOld, ubState, false);
+
+} // setTile
+
+
 QPoint MapGame::teleporterInForOut(const quint8 ubState) {
 
 	if (ubState) {
@@ -303,5 +819,118 @@ QPoint MapGame::teleporterOutForIn(const quint8 ubState) {
 } // teleporterOutForIn
 
 
+// blocks do not wrap around the edges, nor did the candidates before
+void MapGame::updateBonusSpot(const int iColumn, const int iRow) {
+
+	if ((0 > iColumn) || (this->ubTotalColumns - 1 <= iColumn)) return;
+	if ((0 > iRow) || (this->ubTotalRows - 1 <= iRow)) return;
+
+	const int iCell = this->cellIndex(quint8(iColumn), quint8(iRow));
+	const int iBelow = iCell + this->ubTotalColumns;
+	const int iIndex = this->aiBonusSpotIndex.at(iCell);
+	const bool bFree = L::isTile(this->tileAt(iCell), L::ClassFreeForBonus)
+					   && L::isTile(this->tileAt(iCell + 1), L::ClassFreeForBonus)
+					   && L::isTile(this->tileAt(iBelow), L::ClassFreeForBonus)
+					   && L::isTile(this->tileAt(iBelow + 1), L::ClassFreeForBonus);
+	int iLast;
+
+	if (bFree == (0 <= iIndex)) return;
+
+	if (bFree) {
+
+		this->aiBonusSpotIndex[iCell] = this->aiBonusSpots.length();
+		this->aiBonusSpots.append(iCell);
+
+		return;
+
+	} // if became free
+
+	// last one takes the place of the one leaving
+	iLast = this->aiBonusSpots.last();
+	this->aiBonusSpots[iIndex] = iLast;
+	this->aiBonusSpotIndex[iLast] = iIndex;
+	this->aiBonusSpots.removeLast();
+	this->aiBonusSpotIndex[iCell] = -1;
+
+} // updateBonusSpot
+
+
+void MapGame::updateBonusSpots(const int iCell) {
+
+	const int iColumn = iCell % this->ubTotalColumns;
+	const int iRow = iCell / this->ubTotalColumns;
+
+	this->updateBonusSpot(iColumn, iRow);
+	this->updateBonusSpot(iColumn - 1, iRow);
+	this->updateBonusSpot(iColumn, iRow - 1);
+	this->updateBonusSpot(iColumn - 1, iRow - 1);
+
+} // updateBonusSpots
+
+
+MapGame::Wander MapGame::wanderTile(const quint8 ubState) {
+
+	if (L::NullTile == ubState) return WanderStop;
+	if (L::isTile(ubState, L::ClassSolid)) return WanderStop;
+
+	switch (ubState) {
+
+		case L::BonusAppleNW:
+		case L::BonusAppleNE:
+		case L::BonusAppleSE:
+		case L::BonusAppleSW:
+			return WanderFound;
+
+		case L::BonusCherryNW:
+		case L::BonusCherryNE:
+		case L::BonusCherrySE:
+		case L::BonusCherrySW:
+			return WanderStop;
+
+		case L::BonusBananaNW:
+		case L::BonusBananaNE:
+		case L::BonusBananaSE:
+		case L::BonusBananaSW:
+			return WanderFound;
+
+		case L::BonusHeartNW:
+		case L::BonusHeartNE:
+		case L::BonusHeartSE:
+		case L::BonusHeartSW:
+			return WanderFound;
+
+		case L::BonusDiamondNW:
+		case L::BonusDiamondNE:
+		case L::BonusDiamondSE:
+		case L::BonusDiamondSW:
+			return WanderFound;
+
+		default:
+			return WanderOn;
+
+	} // switch state
+
+} // wanderTile
+
+
+void MapGame::writeState(QDataStream &oStream) const {
+
+	QPoint oPoint;
+
+	for (int iCell = 0; iCell < this->cellCount(); ++iCell)
+		oStream << this->tileAt(iCell);
+
+	// spots depend on the order tiles changed in
+	oStream << quint16(this->aiBonusSpots.length());
+	for (int i = 0; i < this->aiBonusSpots.length(); ++i) {
+
+		oPoint = this->cellPoint(this->aiBonusSpots.at(i));
+		oStream << quint8(oPoint.x()) << quint8(oPoint.y());
+
+	} // loop spots
+
+} // writeState
+
+
 
 }	} // namespace SwissalpS::QtNibblers
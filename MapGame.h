@@ -18,7 +18,10 @@
 #ifndef MAPGAME_H
 #define MAPGAME_H
 
+#include "Bitboard.h"
 #include "Map.h"
+#include "Random.h"
+#include <QDataStream>
 #include <QHash>
 #include <QObject>
 #include <QVector>
@@ -29,6 +32,17 @@ namespace SwissalpS { namespace QtNibblers {
 
 
 
+// a tile set on a MapGame, see MapGame::tilesChanged()
+struct TileChange {
+	quint16 uiCell;
+	quint8 ubOld;
+	quint8 ubNew;
+	// a worm's tail left the tile
+	bool bTrail;
+}; // TileChange
+
+
+
 class MapGame : public SwissalpS::QtNibblers::Map {
 
 	Q_OBJECT
@@ -44,34 +58,162 @@ public:
 	};
 	Q_ENUM(ErrorCode)
 
+	// what a straight walk of WormAI::wander() makes of a tile
+	enum Wander {
+		WanderOn = 0u,
+		WanderFound = 1u,
+		WanderStop = 2u
+	};
+	Q_ENUM(Wander)
+
 private:
 
 protected:
 	ErrorCode eErrorCode;
-
+	// cells worms do not crash into, kept in step with the tiles
+	Bitboard oFree;
+	// see labelRegions(), cleared whenever a tile changes
+	bool bRegionsValid;
+	// labelRegions() has to go over the whole board, aiRegionsStale is lost
+	bool bRegionsFull;
+	// see setTileChangesWanted()
+	bool bTileChangesWanted;
+	// nesting of beginTileChanges()
+	int iTileChangesDepth;
+	// stamp of the latest relabelStaleRegions(), see auiRegionsSeen
+	quint32 uiRegionsPass;
+	// heads labelRegions() was given
+	QVector<int> aiRegionHeads;
+	// per cell the lowest cell of its region, -1 if in none
+	QVector<int> aiRegions;
+	// per lowest cell of a region the count of its cells
+	QVector<int> aiRegionSizes;
+	// cells that turned free or solid or got next to a head or away from
+	// one since labelRegions(), may repeat
+	QVector<int> aiRegionsStale;
+	// per cell how many of aiRegionHeads it is next to
+	QVector<quint8> aubNearHeads;
+	// per cell uiRegionsPass of the pass that reached it
+	QVector<quint32> auiRegionsSeen;
+	// per cell one bit per heading index (North, West, South, East): going
+	// that way, WormAI::wander() finds a bonus. See refreshLines()
+	QVector<quint8> aubLines;
+	// rows and columns with tiles changed since refreshLines()
+	QVector<bool> abRowsStale;
+	QVector<bool> abColumnsStale;
+
+	// top left cells of free 2x2 blocks, bonuses are placed on a random one
+	QVector<int> aiBonusSpots;
+	// per cell its index in aiBonusSpots, -1 if not in it
+	QVector<int> aiBonusSpotIndex;
 	QVector<QPoint> aPointsSpawn;
+	QVector<quint8> aubTilesFrozen;
 	QHash<quint8, QPoint> hPointsTeleporterIn;
 	QHash<quint8, QPoint> hPointsTeleporterOut;
+	// collected since beginTileChanges()
+	QVector<TileChange> aoTileChanges;
 
 	explicit MapGame(QObject *pParent = nullptr);
 	explicit MapGame(const QByteArray &aFileContents, QObject *pParent = nullptr);
 
 	virtual bool isGoodForBonus(const QPoint oPoint);
+	// is iCell one of the 4 cells around iHead
+	inline bool isNextTo(const int iCell, const int iHead) const {
+		return (iCell == this->neighbour(iHead, L::North))
+				|| (iCell == this->neighbour(iHead, L::West))
+				|| (iCell == this->neighbour(iHead, L::South))
+				|| (iCell == this->neighbour(iHead, L::East)); }
+	// free and next to none of aiRegionHeads
+	inline bool isRegionCell(const int iCell) const {
+		return this->oFree.at(iCell) && (0u == this->aubNearHeads.at(iCell)); }
+	// collects the change or, outside of beginTileChanges(), reports it
+	void onTileChanged(const int iCell, const quint8 ubOld, const quint8 ubNew,
+					   const bool bTrail);
+	// row and column of iCell need refreshLine()
+	inline void markLinesStale(const int iCell) {
+		this->abRowsStale[iCell / this->ubTotalColumns] = true;
+		this->abColumnsStale[iCell % this->ubTotalColumns] = true; }
+	// relabelStaleRegions() has to look at iCell, too many of those and
+	// labelRegions() rather goes over the whole board
+	inline void markRegionStale(const int iCell) {
+		if (this->bRegionsFull) return;
+		if ((this->cellCount() >> 4) > this->aiRegionsStale.length()) {
+			this->aiRegionsStale.append(iCell);
+			return; }
+		this->aiRegionsStale.clear();
+		this->bRegionsFull = true; }
+
+	// bits of aubLines for the row or column iFirst starts going eHeading
+	virtual void refreshLine(const int iFirst, const L::Heading eHeading);
+	// adds or removes the 2x2 block with top left iColumn, iRow
+	void updateBonusSpot(const int iColumn, const int iRow);
+	// the blocks that hold iCell
+	void updateBonusSpots(const int iCell);
 
 public:
 	// use this to get a map. If invalid will return a null-map
 	static MapGame *loadedMap(const QString sFilePath, QObject *pParent = nullptr);
 	virtual ~MapGame();
 
+	// collect tile changes until the matching endTileChanges()
+	void beginTileChanges();
+	// WormAI::wander() from iCell back to it, if isLineFresh()
+	inline bool bonusAhead(const int iCell, const L::Heading eHeading) const {
+		return this->aubLines.at(iCell) & (1u << ((eHeading - L::North) & 3)); }
+
+	// revert tile to the state it had when level was loaded
+	virtual void defrostTile(const QPoint oPoint, const bool bTrail = false);
+	// reports what was collected since the outermost beginTileChanges()
+	void endTileChanges();
 	inline virtual ErrorCode errorCode() const { return this->eErrorCode; }
-	virtual QVector<QPoint> freeSpotForBonus();
+	inline bool isLineFresh(const int iCell, const L::Heading eHeading) const {
+		return ((L::West == eHeading) || (L::East == eHeading))
+				? !this->abRowsStale.at(iCell / this->ubTotalColumns)
+				: !this->abColumnsStale.at(iCell % this->ubTotalColumns); }
+
+	virtual QVector<QPoint> freeSpotForBonus(Random *pRandom);
+	virtual quint8 frozenTile(const QPoint oPoint) const;
+	inline const Bitboard &freeCells() const { return this->oFree; }
+	// union-find over the whole board with aiRegionHeads
+	void labelAllRegions();
+	// splits free cells that are not next to any of aiHeads into
+	// connected regions, valid until a tile changes. Only regions around
+	// cells that changed since last time are labelled again
+	virtual void labelRegions(const QVector<int> aiHeads);
+	// tiles and bonus spots as written by writeState() for same level.
+	// Sets oStream to ReadCorruptData if the spots do not fit the tiles
+	virtual void readState(QDataStream &oStream);
+	// bonusAhead() of rows and columns whose tiles changed since last time
+	virtual void refreshLines();
+	// how many cells can be reached from the neighbours of iStart when
+	// the cells next to aiHeads are blocked except those of aiHeads[iSelf],
+	// which has iNext blocked instead. Also iStart is blocked.
+	// -1 if the regions can not tell, see labelRegions()
+	virtual int regionRoom(const QVector<int> &aiHeads, const int iSelf,
+						   const int iNext, const int iStart) const;
+	// floods the regions next to aiRegionsStale anew
+	void relabelStaleRegions();
 	inline virtual void setErrorCode(const ErrorCode eCode) { this->eErrorCode = eCode; }
+
+	using Map::setTile;
+	virtual void setTile(const quint8 ubColumn, const quint8 ubRow, quint8 ubState) override;
+	// off when nothing reads tilesChanged(), changes are then neither
+	// collected nor reported
+	inline void setTileChangesWanted(const bool bWanted) {
+		this->bTileChangesWanted = bWanted; }
 	inline virtual QVector<QPoint> spawnPoints() { return this->aPointsSpawn; }
 	virtual QPoint teleporterInForOut(const quint8 ubState);
 	virtual QPoint teleporterOutForIn(const quint8 ubState);
+	static Wander wanderTile(const quint8 ubState);
+	// what changes during play, the rest comes from the level file
+	virtual void writeState(QDataStream &oStream) const;
+
+signals:
+	// in the order they were set, a cell may show up more than once
+	void tilesChanged(const QVector<TileChange> &aoChanges) const;
 
 public slots:
-	void randomizeSpawnOrder();
+	void randomizeSpawnOrder(Random *pRandom);
 
 }; // MapGame
 
@@ -27,6 +27,7 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
 	AppSettings.cpp \
+	Bitboard.cpp \
 	Bonus.cpp \
 	DialogLoad.cpp \
 	DialogSave.cpp \
@@ -41,16 +42,23 @@ SOURCES += \
 	Map.cpp \
 	MapGame.cpp \
 	PersistantObject.cpp \
+	Random.cpp \
+	Replay.cpp \
 	ScoreBoard.cpp \
+	SurfaceBoard.cpp \
 	SurfaceBuilder.cpp \
 	SurfaceCell.cpp \
 	SurfaceFrame.cpp \
 	SurfaceGame.cpp \
+	Trace.cpp \
 	Worm.cpp \
-	WormAI.cpp
+	WormAI.cpp \
+	WormAISearch.cpp \
+	WormBody.cpp
 
 HEADERS += \
 	AppSettings.h \
+	Bitboard.h \
 	Bonus.h \
 	definitions.h \
 	DialogLoad.h \
@@ -66,13 +74,19 @@ HEADERS += \
 	Map.h \
 	MapGame.h \
 	PersistantObject.h \
+	Random.h \
+	Replay.h \
 	ScoreBoard.h \
+	SurfaceBoard.h \
 	SurfaceBuilder.h \
 	SurfaceCell.h \
 	SurfaceFrame.h \
 	SurfaceGame.h \
+	Trace.h \
 	Worm.h \
-	WormAI.h
+	WormAI.h \
+	WormAISearch.h \
+	WormBody.h
 
 FORMS += \
 	DialogLoad.ui \
@@ -0,0 +1,92 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Random.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+Random::Random(const quint64 uxSeed) {
+
+	this->seed(uxSeed);
+
+} // construct
+
+
+void Random::getState(quint32 aulOut[4]) const {
+
+	for (int i = 0; i < 4; ++i) aulOut[i] = this->aulState[i];
+
+} // getState
+
+
+quint32 Random::next() {
+
+	quint32 *a = this->aulState;
+
+	const quint32 ulOut = a[1] * 5u;
+	const quint32 ulResult = ((ulOut << 7) | (ulOut >> 25)) * 9u;
+	const quint32 ulT = a[1] << 9;
+
+	a[2] ^= a[0];
+	a[3] ^= a[1];
+	a[1] ^= a[2];
+	a[0] ^= a[3];
+	a[2] ^= ulT;
+	a[3] = (a[3] << 11) | (a[3] >> 21);
+
+	return ulResult;
+
+} // next
+
+
+void Random::seed(const quint64 uxSeed) {
+
+	this->uxSeed = uxSeed;
+
+	// expand seed with splitmix64 so similar seeds give unrelated sequences
+	// and the state can never be all zero
+	quint64 uxZ;
+	quint64 uxX = uxSeed;
+	for (int i = 0; i < 4; i += 2) {
+
+		uxX += Q_UINT64_C(0x9E3779B97F4A7C15);
+		uxZ = uxX;
+		uxZ = (uxZ ^ (uxZ >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+		uxZ = (uxZ ^ (uxZ >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+		uxZ ^= uxZ >> 31;
+
+		this->aulState[i] = quint32(uxZ);
+		this->aulState[i + 1] = quint32(uxZ >> 32);
+
+	} // loop state words
+
+} // seed
+
+
+void Random::setState(const quint32 aulIn[4]) {
+
+	for (int i = 0; i < 4; ++i) this->aulState[i] = aulIn[i];
+
+} // setState
+
+
+
+}	} // namespace SwissalpS::QtNibblers
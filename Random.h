@@ -0,0 +1,64 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <QtGlobal>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// Small, fast and seedable pseudo random number generator (xoshiro128**).
+// Every Game owns one so a game is reproducible from its seed alone and
+// does not depend on the clock or on qsrand() calls elsewhere.
+class Random {
+
+private:
+
+protected:
+	quint64 uxSeed;
+	quint32 aulState[4];
+
+public:
+	explicit Random(const quint64 uxSeed = 0u);
+
+	// uniformly distributed in 0 to ulRange - 1, 0 if ulRange is 0
+	inline quint32 bounded(const quint32 ulRange) {
+		return quint32((quint64(this->next()) * ulRange) >> 32); }
+
+	quint32 next();
+	// restarts sequence
+	void seed(const quint64 uxSeed);
+	inline quint64 seedValue() const { return this->uxSeed; }
+
+	// for snapshots
+	void getState(quint32 aulOut[4]) const;
+	void setState(const quint32 aulIn[4]);
+
+}; // Random
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // RANDOM_H
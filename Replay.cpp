@@ -0,0 +1,497 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Replay.h"
+
+#include "AppSettings.h"
+#include "definitions.h"
+
+#include <algorithm>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+const QByteArray Replay::aMagic = QByteArray("NIBR");
+const QByteArray Replay::aMagicIndex = QByteArray("NIBK");
+// 2 added keyframes, 3 setting ubGameAILookahead, 4 bonus spots from the
+// free-block index. Only this version loads, the others were never released
+const quint8 Replay::ubVersion = 4u;
+const quint8 Replay::ubWormAIEffort = 0xFFu;
+
+
+static void appendUInt32(QByteArray &aBytes, const quint32 ulValue) {
+
+	aBytes.append(char(ulValue & 0xFFu));
+	aBytes.append(char((ulValue >> 8) & 0xFFu));
+	aBytes.append(char((ulValue >> 16) & 0xFFu));
+	aBytes.append(char((ulValue >> 24) & 0xFFu));
+
+} // appendUInt32
+
+
+static quint32 readUInt32(const uchar *pData) {
+
+	return quint32(pData[0]) | (quint32(pData[1]) << 8)
+			| (quint32(pData[2]) << 16) | (quint32(pData[3]) << 24);
+
+} // readUInt32
+
+
+Replay::Replay(QObject *pParent) :
+	QObject(pParent),
+	bRecording(false),
+	ubLevel(0u),
+	iPosition(0),
+	ulBytesWritten(0u),
+	ulKeyframeTicks(0u),
+	ulTicksPending(0u),
+	ulTicksRecorded(0u),
+	pDevice(nullptr) {
+
+	for (int i = 0; i < 4; ++i) this->aulRandom[i] = 0u;
+
+	this->aEvents.clear();
+	this->hSettings.clear();
+	this->aeHeadings.clear();
+	this->aulKeyframeTicks.clear();
+	this->aulKeyframeOffsets.clear();
+
+} // construct
+
+
+Replay::~Replay() {
+
+	this->stopRecording();
+
+} // dealloc
+
+
+void Replay::indexKeyframes() {
+
+	this->aulKeyframeTicks.clear();
+	this->aulKeyframeOffsets.clear();
+	this->iPosition = 0;
+
+	int iStart = 0;
+	quint32 ulTicks = 0u;
+	quint32 ulValue;
+	Token eToken;
+	while (this->readToken(eToken, ulValue)) {
+
+		if (End == eToken) {
+
+			if (0u == ulValue) break;
+
+			this->aulKeyframeTicks.append(ulTicks);
+			this->aulKeyframeOffsets.append(quint32(iStart));
+			this->iPosition += int(ulValue);
+
+		} else if (Heading != eToken) ulTicks += ulValue;
+
+		iStart = this->iPosition;
+
+	} // loop tokens
+
+	this->iPosition = 0;
+
+} // indexKeyframes
+
+
+int Replay::keyframeFor(const quint32 ulTick) const {
+
+	// first keyframe after ulTick, the one before it is ours
+	QVector<quint32>::const_iterator i = std::upper_bound(
+											 this->aulKeyframeTicks.constBegin(),
+											 this->aulKeyframeTicks.constEnd(), ulTick);
+
+	return int(i - this->aulKeyframeTicks.constBegin()) - 1;
+
+} // keyframeFor
+
+
+bool Replay::load(QIODevice *pDevice) {
+
+	this->bRecording = false;
+	this->pDevice = nullptr;
+	this->aEvents.clear();
+	this->hSettings.clear();
+	this->iPosition = 0;
+	this->aulKeyframeTicks.clear();
+	this->aulKeyframeOffsets.clear();
+
+	if (nullptr == pDevice) return false;
+
+	QByteArray aData = pDevice->readAll();
+	if (Replay::aMagic.length() >= aData.length()) return false;
+	if (!aData.startsWith(Replay::aMagic)) return false;
+
+	const uchar *pData = reinterpret_cast<const uchar *>(aData.constData());
+	int iPos = Replay::aMagic.length();
+
+	if (Replay::ubVersion != pData[iPos]) return false;
+	iPos++;
+
+	const QStringList asKeys = Replay::settingKeys();
+	// magic, version, random state, level, settings, colours
+	const int iHeader = Replay::aMagic.length() + 1 + 16 + 1 + asKeys.length()
+						+ SssS_Nibblers_Max_Players;
+
+	if (iHeader > aData.length()) return false;
+
+	for (int i = 0; i < 4; ++i) {
+
+		this->aulRandom[i] = readUInt32(pData + iPos);
+		iPos += 4;
+
+	} // loop random state
+
+	this->ubLevel = pData[iPos++];
+
+	for (int i = 0; i < asKeys.length(); ++i)
+		this->hSettings.insert(asKeys.at(i), uint(pData[iPos++]));
+
+	QList<QVariant> aColours;
+	for (int i = 0; i < SssS_Nibblers_Max_Players; ++i)
+		aColours.append(uint(pData[iPos++]));
+
+	this->hSettings.insert(AppSettings::sSettingGameColours, aColours);
+
+	// keyframe index is missing if recording was interrupted
+	int iEnd = aData.length();
+	const int iCountAt = iEnd - Replay::aMagicIndex.length() - 4;
+	bool bIndexed = false;
+	if ((iPos <= iCountAt) && aData.endsWith(Replay::aMagicIndex)) {
+
+		const quint32 ulCount = readUInt32(pData + iCountAt);
+		if (ulCount <= quint32(iCountAt - iPos) / 8u) {
+
+			iEnd = iCountAt - int(ulCount) * 8;
+			for (int i = iEnd; i < iCountAt; i += 8) {
+
+				this->aulKeyframeTicks.append(readUInt32(pData + i));
+				this->aulKeyframeOffsets.append(readUInt32(pData + i + 4));
+
+			} // loop index
+
+			bIndexed = true;
+
+		} // if count fits
+
+	} // if has index
+
+	this->aEvents = aData.mid(iPos, iEnd - iPos);
+
+	if (!bIndexed) this->indexKeyframes();
+
+	return true;
+
+} // load
+
+
+bool Replay::nextToken(Token &eToken, quint32 &ulValue) {
+
+	while (this->readToken(eToken, ulValue)) {
+
+		// playback does not need keyframes
+		if ((End != eToken) || (0u == ulValue)) return true;
+
+		this->iPosition += int(ulValue);
+
+	} // loop tokens
+
+	return false;
+
+} // nextToken
+
+
+bool Replay::peekToken(Token &eToken, quint32 &ulValue) {
+
+	const int iPositionBefore = this->iPosition;
+	const bool bOK = this->nextToken(eToken, ulValue);
+	this->iPosition = iPositionBefore;
+
+	return bOK;
+
+} // peekToken
+
+
+void Replay::randomState(quint32 aulOut[4]) const {
+
+	for (int i = 0; i < 4; ++i) aulOut[i] = this->aulRandom[i];
+
+} // randomState
+
+
+bool Replay::readToken(Token &eToken, quint32 &ulValue) {
+
+	quint32 ulRaw = 0u;
+	quint8 ubShift = 0u;
+	uchar ubByte;
+	do {
+
+		if (this->aEvents.length() <= this->iPosition) return false;
+		if (28u < ubShift) return false;
+
+		ubByte = uchar(this->aEvents.at(this->iPosition++));
+		ulRaw |= quint32(ubByte & 0x7Fu) << ubShift;
+		ubShift += 7u;
+
+	} while (ubByte & 0x80u);
+
+	eToken = Token(ulRaw & 3u);
+	ulValue = ulRaw >> 2;
+
+	return true;
+
+} // readToken
+
+
+void Replay::recordAIEffort(const quint8 ubEffort) {
+
+	if (!this->bRecording) return;
+
+	this->writeTicksPending();
+	this->writeToken(Heading, (quint32(Replay::ubWormAIEffort) << 2) | (ubEffort & 3u));
+
+} // recordAIEffort
+
+
+void Replay::recordBonusTick() {
+
+	if (!this->bRecording) return;
+
+	this->writeToken(TicksThenBonus, this->ulTicksPending);
+	this->ulTicksPending = 0u;
+
+} // recordBonusTick
+
+
+void Replay::recordHeading(const int iWorm, const L::Heading eHeading) {
+
+	if (!this->bRecording) return;
+
+	this->writeTicksPending();
+
+	this->writeToken(Heading, (quint32(iWorm) << 2) | quint32(eHeading - L::North));
+
+} // recordHeading
+
+
+void Replay::recordKeyframe(const QByteArray &aState) {
+
+	if (!this->bRecording) return;
+
+	// an empty one would read as end marker
+	if (aState.isEmpty()) return;
+
+	// keyframe goes between ticks, not into a run of them
+	this->writeTicksPending();
+
+	this->aulKeyframeTicks.append(this->ulTicksRecorded);
+	this->aulKeyframeOffsets.append(this->ulBytesWritten);
+
+	this->writeToken(End, quint32(aState.length()));
+	this->pDevice->write(aState);
+	this->ulBytesWritten += quint32(aState.length());
+
+} // recordKeyframe
+
+
+void Replay::recordTick(const QVector<Worm *> apWorms) {
+
+	if (!this->bRecording) return;
+
+	if (this->aeHeadings.length() != apWorms.length())
+		this->aeHeadings.fill(L::Nowhere, apWorms.length());
+
+	Worm *pWorm;
+	L::Heading eHeading;
+	for (int i = 0; i < apWorms.length(); ++i) {
+
+		pWorm = apWorms.at(i);
+
+		if (pWorm->isAI()) continue;
+
+		eHeading = pWorm->currentDirection();
+		if (eHeading == this->aeHeadings.at(i)) continue;
+		if ((L::North > eHeading) || (L::East < eHeading)) continue;
+
+		this->aeHeadings[i] = eHeading;
+		this->recordHeading(i, eHeading);
+
+	} // loop worms
+
+	this->ulTicksPending++;
+	this->ulTicksRecorded++;
+
+} // recordTick
+
+
+bool Replay::seekKeyframe(const int iIndex, QByteArray &aState) {
+
+	if ((0 > iIndex) || (this->keyframeCount() <= iIndex)) return false;
+
+	const int iPositionBefore = this->iPosition;
+	this->iPosition = int(this->aulKeyframeOffsets.at(iIndex));
+
+	quint32 ulValue;
+	Token eToken;
+	if (!this->readToken(eToken, ulValue) || (End != eToken) || (0u == ulValue)
+			|| (this->aEvents.length() < this->iPosition + int(ulValue))) {
+
+		this->iPosition = iPositionBefore;
+
+		return false;
+
+	} // if index does not point at a keyframe
+
+	aState = this->aEvents.mid(this->iPosition, int(ulValue));
+	this->iPosition += int(ulValue);
+
+	return true;
+
+} // seekKeyframe
+
+
+void Replay::setRandomState(const quint32 aulIn[4]) {
+
+	for (int i = 0; i < 4; ++i) this->aulRandom[i] = aulIn[i];
+
+} // setRandomState
+
+
+// static
+QStringList Replay::settingKeys() {
+
+	// order matters, it is the order in the file. New keys go last.
+	QStringList asKeys = QStringList()
+			<< AppSettings::sSettingGameBadLevelMode
+			<< AppSettings::sSettingGameCountAIs
+			<< AppSettings::sSettingGameCountHumans
+			<< AppSettings::sSettingGameFakeBonuses
+			<< AppSettings::sSettingGameLimitLives
+			<< AppSettings::sSettingGameOverOnLastDead
+			<< AppSettings::sSettingGameSpeed
+			<< AppSettings::sSettingGameStartLives
+			<< AppSettings::sSettingGameAILookahead;
+
+	return asKeys;
+
+} // settingKeys
+
+
+bool Replay::startRecording(QIODevice *pDevice) {
+
+	this->stopRecording();
+
+	if (nullptr == pDevice) return false;
+	if (!pDevice->isWritable()) return false;
+
+	QByteArray aHeader = Replay::aMagic;
+	aHeader.append(char(Replay::ubVersion));
+
+	for (int i = 0; i < 4; ++i) appendUInt32(aHeader, this->aulRandom[i]);
+
+	aHeader.append(char(this->ubLevel));
+
+	const QStringList asKeys = Replay::settingKeys();
+	for (int i = 0; i < asKeys.length(); ++i)
+		aHeader.append(char(this->hSettings.value(asKeys.at(i)).toUInt()));
+
+	QList<QVariant> aColours = this->hSettings.value(
+								   AppSettings::sSettingGameColours).toList();
+	for (int i = 0; i < SssS_Nibblers_Max_Players; ++i)
+		aHeader.append(char(aColours.value(i, i).toUInt()));
+
+	if (aHeader.length() != pDevice->write(aHeader)) return false;
+
+	this->pDevice = pDevice;
+	this->bRecording = true;
+	this->ulTicksPending = 0u;
+	this->ulTicksRecorded = 0u;
+	this->ulBytesWritten = 0u;
+	this->aeHeadings.clear();
+	this->aulKeyframeTicks.clear();
+	this->aulKeyframeOffsets.clear();
+
+	return true;
+
+} // startRecording
+
+
+void Replay::stopRecording() {
+
+	if (!this->bRecording) return;
+
+	if (this->ulTicksPending) this->writeToken(Ticks, this->ulTicksPending);
+	this->writeToken(End, 0u);
+
+	QByteArray aIndex;
+	for (int i = 0; i < this->aulKeyframeTicks.length(); ++i) {
+
+		appendUInt32(aIndex, this->aulKeyframeTicks.at(i));
+		appendUInt32(aIndex, this->aulKeyframeOffsets.at(i));
+
+	} // loop keyframes
+
+	appendUInt32(aIndex, quint32(this->aulKeyframeTicks.length()));
+	aIndex.append(Replay::aMagicIndex);
+	this->pDevice->write(aIndex);
+
+	this->bRecording = false;
+	this->ulTicksPending = 0u;
+	this->pDevice = nullptr;
+
+} // stopRecording
+
+
+void Replay::writeTicksPending() {
+
+	if (0u == this->ulTicksPending) return;
+
+	this->writeToken(Ticks, this->ulTicksPending);
+	this->ulTicksPending = 0u;
+
+} // writeTicksPending
+
+
+void Replay::writeToken(const Token eToken, const quint32 ulValue) {
+
+	// unsigned LEB128
+	char aBytes[5];
+	int iCount = 0;
+	quint32 ulRaw = (ulValue << 2) | quint32(eToken);
+	do {
+
+		aBytes[iCount] = char(ulRaw & 0x7Fu);
+		ulRaw >>= 7;
+		if (ulRaw) aBytes[iCount] = char(aBytes[iCount] | 0x80);
+		++iCount;
+
+	} while (ulRaw);
+
+	this->pDevice->write(aBytes, iCount);
+	this->ulBytesWritten += quint32(iCount);
+
+} // writeToken
+
+
+
+}	} // namespace SwissalpS::QtNibblers
@@ -0,0 +1,164 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QObject>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include "Lingo.h"
+#include "Worm.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// Compact recording of one game: random generator state, start level and
+// the settings that influence play, followed by a stream of varint tokens.
+// Token value is (ulValue << 2) | Token
+//   Ticks           ulValue ticks ran
+//   TicksThenBonus  ulValue ticks ran, then one bonus tick
+//   Heading         a human worm's heading for the ticks that follow,
+//                   ulValue = (worm index << 2) | (heading - North)
+//                   worm index ubWormAIEffort instead carries Game's
+//                   WormAI::Effort for the ticks that follow
+//   End             end of game if ulValue is 0, else a keyframe of
+//                   ulValue bytes follows, see Game::saveState()
+// AI worms are not recorded, they follow from the random state. Those
+// whose WormAI::isRecorded() are, as their headings depend on timing.
+// After the end marker comes the keyframe index: per keyframe tick and
+// offset into the stream (both quint32 little-endian), keyframe count and
+// aMagicIndex. Keyframes let viewers seek without replaying from tick 0.
+class Replay : public QObject {
+
+	Q_OBJECT
+
+public:
+	enum Token {
+		Ticks = 0u,
+		TicksThenBonus = 1u,
+		Heading = 2u,
+		End = 3u
+	};
+	Q_ENUM(Token)
+
+	static const QByteArray aMagic;
+	static const QByteArray aMagicIndex;
+	static const quint8 ubVersion;
+	// no worm has this index, see Heading
+	static const quint8 ubWormAIEffort;
+
+private:
+
+protected:
+	bool bRecording;
+	quint8 ubLevel;
+	int iPosition;
+	quint32 ulBytesWritten;
+	quint32 ulKeyframeTicks;
+	quint32 ulTicksPending;
+	quint32 ulTicksRecorded;
+	quint32 aulRandom[4];
+	QByteArray aEvents;
+	QHash<QString, QVariant> hSettings;
+	QIODevice *pDevice;
+	QVector<L::Heading> aeHeadings;
+	// ascending ticks and where their keyframe token starts in aEvents
+	QVector<quint32> aulKeyframeTicks;
+	QVector<quint32> aulKeyframeOffsets;
+
+	// for replays whose recording did not finish
+	virtual void indexKeyframes();
+	// like nextToken() but does not skip keyframes
+	virtual bool readToken(Token &eToken, quint32 &ulValue);
+	virtual void writeToken(const Token eToken, const quint32 ulValue);
+	// so tokens that follow apply after ticks recorded so far
+	virtual void writeTicksPending();
+
+public:
+	explicit Replay(QObject *pParent = nullptr);
+	virtual ~Replay() override;
+
+	// true when recordKeyframe() should be called before recordTick()
+	inline virtual bool isKeyframeDue() const {
+		return this->bRecording && this->ulKeyframeTicks && this->ulTicksRecorded
+				&& (0u == this->ulTicksRecorded % this->ulKeyframeTicks); }
+
+	inline virtual bool isRecording() const { return this->bRecording; }
+	inline virtual int keyframeCount() const { return this->aulKeyframeTicks.length(); }
+	// index of last keyframe taken at or before ulTick, -1 if there is none
+	virtual int keyframeFor(const quint32 ulTick) const;
+	inline virtual quint32 keyframeTick(const int iIndex) const {
+		return this->aulKeyframeTicks.value(iIndex); }
+
+	inline virtual quint8 level() const { return this->ubLevel; }
+	// reads header, events and keyframe index, returns false if not a valid replay
+	virtual bool load(QIODevice *pDevice);
+	// next token of a loaded replay, false when there are no more
+	virtual bool nextToken(Token &eToken, quint32 &ulValue);
+	// like nextToken() but stays where it is
+	virtual bool peekToken(Token &eToken, quint32 &ulValue);
+	virtual void randomState(quint32 aulOut[4]) const;
+	// AI effort Game switched to for the ticks that follow
+	virtual void recordAIEffort(const quint8 ubEffort);
+	// call before each bonus tick
+	virtual void recordBonusTick();
+	// heading of worm iWorm for the ticks that follow, recordTick() does
+	// this for human worms
+	virtual void recordHeading(const int iWorm, const L::Heading eHeading);
+	// call before recordTick() when isKeyframeDue()
+	virtual void recordKeyframe(const QByteArray &aState);
+	// call before each tick
+	virtual void recordTick(const QVector<Worm *> apWorms);
+	inline virtual void rewind() { this->iPosition = 0; }
+	// positions nextToken() right after keyframe iIndex and returns its state
+	virtual bool seekKeyframe(const int iIndex, QByteArray &aState);
+	// ticks between keyframes, 0 for none
+	inline virtual void setKeyframeTicks(const quint32 ulTicks) {
+		this->ulKeyframeTicks = ulTicks; }
+
+	inline virtual void setLevel(const quint8 ubLevel) { this->ubLevel = ubLevel; }
+	virtual void setRandomState(const quint32 aulIn[4]);
+	// only the keys in settingKeys() and the colours are stored
+	inline virtual void setSetting(const QString &sKey, const QVariant &mValue) {
+		this->hSettings.insert(sKey, mValue); }
+
+	// keys of settings stored
+	static QStringList settingKeys();
+	inline virtual QHash<QString, QVariant> settings() const { return this->hSettings; }
+	// writes header, then tokens as they come in
+	virtual bool startRecording(QIODevice *pDevice);
+	virtual void stopRecording();
+	// recorded so far
+	inline virtual quint32 ticksRecorded() const { return this->ulTicksRecorded; }
+
+}; // Replay
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // REPLAY_H
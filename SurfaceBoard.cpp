@@ -0,0 +1,281 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SurfaceBoard.h"
+
+#include "SurfaceCell.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+SurfaceBoard::SurfaceBoard(const quint8 ubColumns, const quint8 ubRows,
+						   QWidget *pParent) :
+	QWidget(pParent),
+	pTimer(nullptr),
+	ubColumns(ubColumns),
+	ubRows(ubRows) {
+
+	this->aubStates.fill(L::FloorClean, ubColumns * ubRows);
+	this->aubStatesFrozen.fill(L::FloorClean, ubColumns * ubRows);
+	this->aubBloated.fill(0u, ubColumns * ubRows);
+
+	this->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+	this->pTimer = new QTimer(this);
+	this->pTimer->setInterval(108);
+	this->pTimer->setTimerType(Qt::PreciseTimer);
+
+	connect(this->pTimer, SIGNAL(timeout()),
+			this, SLOT(onDesnakeTimer()));
+
+} // construct
+
+
+SurfaceBoard::~SurfaceBoard() {
+
+	this->pTimer->stop();
+
+} // dealloc
+
+
+void SurfaceBoard::addBloatedHeading(const int iCell, const L::Heading eHeading) {
+
+	if ((0 > iCell) || (this->cellCount() <= iCell)) return;
+
+	this->aubBloated[iCell] = this->aubBloated.at(iCell)
+							  | quint8(1u << ((eHeading - L::North) & 3));
+
+	this->updateCell(iCell);
+
+} // addBloatedHeading
+
+
+// same split of the width and height as the layouts gave the cells
+QRect SurfaceBoard::cellRect(const int iCell) const {
+
+	const int iColumn = iCell % this->ubColumns;
+	const int iRow = iCell / this->ubColumns;
+	const int iLeft = iColumn * this->width() / this->ubColumns;
+	const int iTop = iRow * this->height() / this->ubRows;
+
+	return QRect(iLeft, iTop,
+				 (iColumn + 1) * this->width() / this->ubColumns - iLeft,
+				 (iRow + 1) * this->height() / this->ubRows - iTop);
+
+} // cellRect
+
+
+void SurfaceBoard::clear() {
+
+	this->aubStates.fill(L::FloorClean);
+	this->aubStatesFrozen.fill(L::FloorClean);
+	this->aubBloated.fill(0u);
+	this->aiWet.clear();
+	this->pTimer->stop();
+
+	this->update();
+
+} // clear
+
+
+void SurfaceBoard::defrostState(const int iCell) {
+
+	this->aubBloated[iCell] = 0u;
+	this->aubStates[iCell] = this->aubStatesFrozen.at(iCell);
+
+	this->updateCell(iCell);
+
+} // defrostState
+
+
+void SurfaceBoard::desnakeState(const int iCell) {
+
+	if (1 > this->pTimer->interval()) {
+
+		this->defrostState(iCell);
+
+		return;
+
+	} // if no need to bother
+
+	// cycle through slime states on the timer and eventually reach
+	// original state
+
+	this->aubBloated[iCell] = 0u;
+	this->aubStates[iCell] = L::FloorWet9;
+
+	this->updateCell(iCell);
+
+	if (!this->aiWet.contains(iCell)) this->aiWet.append(iCell);
+	if (!this->pTimer->isActive()) this->pTimer->start();
+
+} // desnakeState
+
+
+QSize SurfaceBoard::minimumSizeHint() const {
+
+	// SurfaceCell is at least 4 by 4
+	return QSize(this->ubColumns * 4, this->ubRows * 4);
+
+} // minimumSizeHint
+
+
+void SurfaceBoard::onDesnakeTimer() {
+
+	int iCell;
+	quint8 ubState;
+
+	for (int i = this->aiWet.length() - 1; 0 <= i; --i) {
+
+		iCell = this->aiWet.at(i);
+		ubState = this->aubStates.at(iCell);
+
+		// already moved on to other state
+		if ((L::FloorClean == ubState) || (L::FloorWet9 < ubState)) {
+
+			this->aiWet.remove(i);
+
+			continue;
+
+		} // if not fading any more
+
+		ubState--;
+		if (L::FloorClean == ubState) {
+
+			this->defrostState(iCell);
+			this->aiWet.remove(i);
+
+			continue;
+
+		} // if returning to normal
+
+		this->aubStates[iCell] = ubState;
+		this->updateCell(iCell);
+
+	} // loop wet cells
+
+	if (this->aiWet.isEmpty()) this->pTimer->stop();
+
+} // onDesnakeTimer
+
+
+void SurfaceBoard::onTilesChanged(const QVector<TileChange> &aoChanges) {
+
+	int iCell;
+
+	for (int i = 0; i < aoChanges.length(); ++i) {
+
+		const TileChange &oChange = aoChanges.at(i);
+
+		iCell = oChange.uiCell;
+		if (this->cellCount() <= iCell) continue;
+
+		// worm's tail moved on, let cell fade back to original state
+		if (oChange.bTrail) {
+
+			this->desnakeState(iCell);
+
+			continue;
+
+		} // if trail
+
+		// back to original state
+		if (this->aubStatesFrozen.at(iCell) == oChange.ubNew) {
+
+			this->defrostState(iCell);
+
+			continue;
+
+		} // if defrosted
+
+		this->setState(iCell, oChange.ubNew);
+
+	} // loop changes
+
+} // onTilesChanged
+
+
+void SurfaceBoard::paintEvent(QPaintEvent *pEvent) {
+
+	if (0 == this->cellCount()) return;
+
+	QPainter oP(this);
+	QRect oRectCell;
+	int iColumn;
+	int iColumnLast;
+	int iRow;
+	int iRowLast;
+	int iCell;
+
+	// only the tiles under the damaged rectangles, one more on each side
+	// as integer division may round either way. Clipped to each, so tiles
+	// with some transparency are not drawn twice over where they straddle
+	for (const QRect &oRect : pEvent->region()) {
+
+		oP.setClipRect(oRect);
+
+		iColumnLast = qMin(this->ubColumns - 1,
+						   (oRect.right() + 1) * this->ubColumns
+						   / qMax(1, this->width()) + 1);
+		iRowLast = qMin(this->ubRows - 1,
+						(oRect.bottom() + 1) * this->ubRows
+						/ qMax(1, this->height()) + 1);
+
+		for (iRow = qMax(0, oRect.top() * this->ubRows
+						 / qMax(1, this->height()) - 1);
+			 iRow <= iRowLast; ++iRow) {
+
+			for (iColumn = qMax(0, oRect.left() * this->ubColumns
+								/ qMax(1, this->width()) - 1);
+				 iColumn <= iColumnLast; ++iColumn) {
+
+				iCell = iRow * this->ubColumns + iColumn;
+				oRectCell = this->cellRect(iCell);
+				if (!oRectCell.intersects(oRect)) continue;
+
+				SurfaceCell::paintState(oP, oRectCell, this->aubStates.at(iCell),
+										false, this->aubBloated.at(iCell));
+
+			} // loop columns
+
+		} // loop rows
+
+	} // loop damaged rectangles
+
+} // paintEvent
+
+
+void SurfaceBoard::setState(const int iCell, const quint8 ubState) {
+
+	// nothing to do?
+	if (ubState == this->aubStates.at(iCell)) return;
+
+	this->aubStates[iCell] = ubState;
+
+	this->updateCell(iCell);
+
+} // setState
+
+
+
+}	} // namespace SwissalpS::QtNibblers
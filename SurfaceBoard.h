@@ -0,0 +1,103 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SURFACEBOARD_H
+#define SURFACEBOARD_H
+
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+#include "Lingo.h"
+#include "MapGame.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// the whole board in one widget instead of one SurfaceCell per tile.
+// Changed tiles mark their rectangle dirty and paintEvent() only draws
+// the tiles in the damaged region.
+class SurfaceBoard : public QWidget {
+
+	Q_OBJECT
+
+private:
+	// steps all fading trails at once
+	QTimer *pTimer;
+
+protected:
+	quint8 ubColumns;
+	quint8 ubRows;
+	// per cell a L::Tiles
+	QVector<quint8> aubStates;
+	// per cell the state it had on level load
+	QVector<quint8> aubStatesFrozen;
+	// per cell a bit per heading index a bonus was eaten going
+	QVector<quint8> aubBloated;
+	// cells fading back to their frozen state
+	QVector<int> aiWet;
+
+	QRect cellRect(const int iCell) const;
+	virtual void paintEvent(QPaintEvent *pEvent) override;
+	inline void updateCell(const int iCell) { this->update(this->cellRect(iCell)); }
+
+protected slots:
+	virtual void onDesnakeTimer();
+
+public:
+	explicit SurfaceBoard(const quint8 ubColumns, const quint8 ubRows,
+						  QWidget *pParent = nullptr);
+	virtual ~SurfaceBoard() override;
+
+	virtual void addBloatedHeading(const int iCell, const L::Heading eHeading);
+	inline int cellCount() const { return this->aubStates.length(); }
+	inline int cellIndex(const QPoint oPoint) const {
+		return oPoint.y() * this->ubColumns + oPoint.x(); }
+	// every tile clean floor, also when defrosted
+	virtual void clear();
+	inline quint8 columns() const { return this->ubColumns; }
+	inline bool contains(const QPoint oPoint) const {
+		return (0 <= oPoint.x()) && (this->ubColumns > oPoint.x())
+				&& (0 <= oPoint.y()) && (this->ubRows > oPoint.y()); }
+	virtual void defrostState(const int iCell);
+	virtual void desnakeState(const int iCell);
+	inline void freezeState(const int iCell) {
+		this->aubStatesFrozen[iCell] = this->aubStates.at(iCell); }
+	virtual QSize minimumSizeHint() const override;
+	inline quint8 rows() const { return this->ubRows; }
+	virtual void setState(const int iCell, const quint8 ubState);
+	inline quint8 state(const int iCell) const { return this->aubStates.at(iCell); }
+	inline quint8 stateFrozen(const int iCell) const {
+		return this->aubStatesFrozen.at(iCell); }
+
+public slots:
+	// same as SurfaceGame::onTilesChanged() does with cells
+	virtual void onTilesChanged(const QVector<TileChange> &aoChanges);
+	inline void onTrailChanged(const int iValue) { this->pTimer->setInterval(iValue); }
+
+}; // SurfaceBoard
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // SURFACEBOARD_H
@@ -157,6 +157,39 @@ void SurfaceBuilder::clearSurfaceOf(const QVector<quint8> aStates) {
 } // clearSurfaceOf(vector)
 
 
+// like clearSurfaceOf(vector) for all states in any of ubClasses, see L::TileClass
+void SurfaceBuilder::clearSurfaceOfClass(const quint8 ubClasses) {
+
+	quint8 ubRows = this->aopRows.count();
+	quint8 ubColumns = this->aopRows.first().count();
+	quint8 ubX = 0u;
+	quint8 ubY = 0u;
+	QList<SurfaceCell*> aRow;
+	SurfaceCell *pCell;
+
+	for (ubY = 0u; ubY < ubRows; ubY++) {
+
+		aRow = this->aopRows.at(ubY);
+
+		for (ubX = 0u; ubX < ubColumns; ubX++) {
+
+			pCell = aRow.at(ubX);
+
+			if (L::isTile(pCell->getState(), ubClasses)) {
+
+				this->setCellState(pCell, L::FloorClean, false);
+
+			} // if one to clear
+
+		} // loop columns
+
+	} // loop rows
+
+	this->update();
+
+} // clearSurfaceOfClass
+
+
 QIcon SurfaceBuilder::currentBrushIcon() const {
 
 	return IconEngine::cell(this->currentBrushState(), true);
@@ -488,26 +521,22 @@ void SurfaceBuilder::loadCurrentLevel() {
 
 void SurfaceBuilder::on_buttonClear_clicked() {
 
-	QVector<quint8> aStates;
-
 	switch (this->pUi->selectClear->currentIndex()) {
 
 		case 1: // Walls
-			this->clearSurfaceOf(IconEngine::statesWalls());
+			this->clearSurfaceOfClass(L::ClassWall);
 		break;
 
 		case 2: // Spawns
-			this->clearSurfaceOf(IconEngine::statesSpawns());
+			this->clearSurfaceOfClass(L::ClassSpawn);
 		break;
 
 		case 3: // Teleporters
-			aStates = IconEngine::statesTeleporterEntrances();
-			aStates.append(IconEngine::statesTeleporterExits());
-			this->clearSurfaceOf(aStates);
+			this->clearSurfaceOfClass(L::ClassTeleporterIn | L::ClassTeleporterOut);
 		break;
 
 		case 4: // Snakes
-			this->clearSurfaceOf(IconEngine::statesSnakes());
+			this->clearSurfaceOfClass(L::ClassSnake);
 		break;
 
 		case 0:
@@ -733,21 +762,18 @@ void SurfaceBuilder::setCellState(SurfaceCell *pCell, const quint8 ubState,
 
 	} // if same state
 
-	static QVector<quint8> aStatesSpawns = IconEngine::statesSpawns();
-	static QVector<quint8> aStatesTeleporterEntrances = IconEngine::statesTeleporterEntrances();
-	static QVector<quint8> aStatesTeleporterExits = IconEngine::statesTeleporterExits();
 
 	// check old state first
 	bool bUpdateStatus = false;
 	SurfaceCell *pCell2;
 	quint8 ubStatePartner;
 
-	if (aStatesSpawns.contains(ubStateOld)) {
+	if (L::isTile(ubStateOld, L::ClassSpawn)) {
 
 		if (this->apSpawnPoints.contains(pCell)) this->apSpawnPoints.removeOne(pCell);
 		bUpdateStatus = true;
 
-	} else if (aStatesTeleporterEntrances.contains(ubStateOld)) {
+	} else if (L::isTile(ubStateOld, L::ClassTeleporterIn)) {
 
 		// overwriting an entrance -> delete the exit too
 		if (this->hpTeleporterEntrances.contains(ubStateOld)) {
@@ -762,7 +788,7 @@ void SurfaceBuilder::setCellState(SurfaceCell *pCell, const quint8 ubState,
 		}
 		bUpdateStatus = true;
 
-	} else if (aStatesTeleporterExits.contains(ubStateOld)) {
+	} else if (L::isTile(ubStateOld, L::ClassTeleporterOut)) {
 
 		// overwriting an exit -> delete the entrance too
 		if (this->hpTeleporterExits.contains(ubStateOld)) {
@@ -781,17 +807,17 @@ void SurfaceBuilder::setCellState(SurfaceCell *pCell, const quint8 ubState,
 
 	// now keep track of new one
 
-	if (aStatesSpawns.contains(ubState)) {
+	if (L::isTile(ubState, L::ClassSpawn)) {
 
 		this->apSpawnPoints.append(pCell);
 		bUpdateStatus = true;
 
-	} else if (aStatesTeleporterEntrances.contains(ubState)) {
+	} else if (L::isTile(ubState, L::ClassTeleporterIn)) {
 
 		this->hpTeleporterEntrances.insert(ubState, pCell);
 		bUpdateStatus = true;
 
-	} else if (aStatesTeleporterExits.contains(ubState)) {
+	} else if (L::isTile(ubState, L::ClassTeleporterOut)) {
 
 		this->hpTeleporterExits.insert(ubState, pCell);
 		bUpdateStatus = true;
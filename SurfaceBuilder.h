@@ -71,6 +71,7 @@ protected:
 	virtual void clearSurface();
 	virtual void clearSurfaceOf(const quint8 ubState);
 	virtual void clearSurfaceOf(const QVector<quint8>aStates);
+	virtual void clearSurfaceOfClass(const quint8 ubClasses);
 	virtual QIcon currentBrushIcon() const;
 	virtual quint8 currentBrushState() const;
 	virtual void loadCurrentLevel();
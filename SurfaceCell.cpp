@@ -20,6 +20,7 @@
 
 #include "definitions.h"
 #include "IconEngine.h"
+#include "Trace.h"
 
 #include <QMouseEvent>
 #include <QPaintEvent>
@@ -107,10 +108,7 @@ void SurfaceCell::changeEvent(QEvent *pEvent) {
 		break;
 
 		default:
-			this->onDebugMessage(" " + QString::number(this->ubColumn)
-								 + " : " + QString::number(this->ubRow)
-								 + " " + QString::number(pEvent->type()));
-
+			SssS_Nibblers_Trace_Detail(PhaseCellEvent, quint32(pEvent->type()));
 		break;
 
 	} // switch
@@ -118,9 +116,9 @@ void SurfaceCell::changeEvent(QEvent *pEvent) {
 } // changeEvent
 
 
-QColor SurfaceCell::colour() const {
+QColor SurfaceCell::colour(const quint8 ubState) {
 
-	switch (this->ubState) {
+	switch (ubState) {
 
 		// most common -> empty space
 		case L::FloorClean:
@@ -242,7 +240,7 @@ QColor SurfaceCell::colour() const {
 
 		default: return QColor(Qt::lightGray);
 
-	} // switch this->ubState
+	} // switch ubState
 
 	/*
 		color0,
@@ -357,19 +355,25 @@ void SurfaceCell::onDesnakeTimer() {
 
 void SurfaceCell::paintEvent(QPaintEvent *pEvent) {
 
-	static QVector<quint8> aubSnakes = IconEngine::statesSnakes();
-	static QVector<quint8> aubWetFloors = IconEngine::statesFloorsWet();
-
 	QFrame::paintEvent(pEvent);
 
 	QPainter oP(this);
 
-	QIcon oIcon = IconEngine::cell(this->ubState, this->bBuilder);
+	SurfaceCell::paintState(oP, this->rect(), this->ubState, this->bBuilder,
+							this->aeHeadingsBloated.length());
+
+}  // paintEvent
+
+
+void SurfaceCell::paintState(QPainter &oP, const QRect &oRect, const quint8 ubState,
+							 const bool bBuilder, const bool bBloated) {
+
+	QIcon oIcon = IconEngine::cell(ubState, bBuilder);
 
 	if (!oIcon.isNull()) {
 
 		// draw icon
-		oP.drawPixmap(this->rect(), oIcon.pixmap(this->size()));
+		oP.drawPixmap(oRect, oIcon.pixmap(oRect.size()));
 
 		return;
 
@@ -377,113 +381,53 @@ void SurfaceCell::paintEvent(QPaintEvent *pEvent) {
 
 	// empty icon returned
 
-	if (this->bBuilder) {
+	if (bBuilder) {
 
 		// draw floor tile for builder
 		oP.setBrush(Qt::lightGray);
 		oP.setPen(Qt::darkGray);
-		oP.drawRoundedRect(this->rect(), this->width() * 0.32,
-						   this->height() * 0.32);
+		oP.drawRoundedRect(oRect, oRect.width() * 0.32,
+						   oRect.height() * 0.32);
 
 		return;
 
 	} // if builder mode
 
-	QColor oColour = this->colour();
+	QColor oColour = SurfaceCell::colour(ubState);
 
-	if (aubSnakes.contains(this->ubState)) {
+	if (L::isTile(ubState, L::ClassSnake)) {
 
 		// draw snake
 
-		oP.fillRect(this->rect(), Qt::black);
+		oP.fillRect(oRect, Qt::black);
 
-		QRect oRect;
 		int iA = 2;
-		if (this->aeHeadingsBloated.length()) {
+		if (bBloated) {
 
-			oRect = this->rect();
-			oColour = oColour.darker(115);
+			oP.fillRect(oRect, oColour.darker(115));
 
 		} else {
 
-			oRect = this->rect().adjusted(iA, iA, -1 * iA, -1 * iA);
+			oP.fillRect(oRect.adjusted(iA, iA, -1 * iA, -1 * iA), oColour);
 
 		} // if bloated
 
-		oP.fillRect(oRect, oColour);
-
-		return;
-
-		//		oP.setBrush(oColour);
-		//		oP.setPen(Qt::black);
-				//oP.drawRoundedRect(oRect, oRect.width() * 0.32,
-				//				   oRect.height() * 0.32);
-
-		// this 'works' but it didn't look good enough
-		int iBh = int(double(this->height() * 0.42) + 1);
-		int iBw = int(double(this->width() * 0.42) + 1);
-
-		int iSpan;
-		int iStart;
-		L::Heading eHeading;
-
-		oP.setBrush(oColour.darker(125));
-		oP.setPen(oColour.darker(120));
-
-		for (int i = 0; i < this->aeHeadingsBloated.length(); ++i) {
-
-			eHeading = this->aeHeadingsBloated.at(i);
-
-			if (L::North == eHeading) {
-
-				iStart = 0;
-				iSpan = -180;
-				oRect = QRect(0, 0,
-							  this->width(), iBh + 1);
-
-			} else if (L::East == eHeading) {
-
-				iStart = 90;
-				iSpan = 180;
-				oRect = QRect(this->width() - iBw, 0,
-							  iBw + 1, this->height());
-
-			} else if (L::South == eHeading) {
-
-				iStart = 0;
-				iSpan = 180;
-				oRect = QRect(0, this->height() - iBh,
-							  this->width(), iBh + 1);
-
-			} else { // must be West
-
-				iStart = 90;
-				iSpan = -180;
-				oRect = QRect(0, 0,
-							  iBw + 1, this->height());
-
-			} // switch heading
-
-			oP.drawChord(oRect, iStart * 16, iSpan * 16);
-
-		} // loop bloated sides
-
 		return;
 
 	} // if snake
 
-	if (aubWetFloors.contains(this->ubState)) {
+	if (L::isTile(ubState, L::ClassFloorWet)) {
 
 		//oColour = Qt::gray;
 
-		oColour.setAlpha((this->ubState * 192/9));
+		oColour.setAlpha((ubState * 192/9));
 
 	} // if post snake
 
 	// fallback to just a coloured tile
-	oP.fillRect(this->rect(), oColour);
+	oP.fillRect(oRect, oColour);
 
-}  // paintEvent
+} // paintState
 
 
 
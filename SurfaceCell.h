@@ -19,6 +19,7 @@
 #define SURFACECELL_H
 
 #include <QFrame>
+#include <QPainter>
 #include <QTimer>
 
 #include "Lingo.h"
@@ -58,7 +59,6 @@ protected:
 	QVector<L::Heading> aeHeadingsBloated;
 
 	void changeEvent(QEvent *pEvent);
-	QColor colour() const;
 	virtual void mouseReleaseEvent(QMouseEvent *pEvent);
 	virtual void paintEvent(QPaintEvent *pEvent);
 
@@ -75,6 +75,7 @@ public:
 	inline virtual void addBloatedHeading(const L::Heading eHeading) {
 		this->aeHeadingsBloated.append(eHeading); }
 
+	static QColor colour(const quint8 ubState);
 	virtual void defrostState();
 	virtual void desnakeState();
 	inline virtual void freezeState() { this->ubStateFrozen = this->ubState; }
@@ -84,6 +85,9 @@ public:
 	inline virtual quint8 getState() const { return this->ubState; }
 	inline virtual quint8 getStateFrozen() const { return this->ubStateFrozen; }
 	inline virtual bool isNull() const { return nullptr == this->pUi; }
+	// draws ubState into oRect, shared with SurfaceBoard
+	static void paintState(QPainter &oP, const QRect &oRect, const quint8 ubState,
+						   const bool bBuilder, const bool bBloated);
 
 	inline virtual void setState(const quint8 ubState) {
 		this->ubState = ubState; this->onChanged(); }
@@ -20,6 +20,7 @@
 
 #include "definitions.h"
 #include "IconEngine.h"
+#include "Trace.h"
 
 #include <QHBoxLayout>
 #include <QTimer>
@@ -37,8 +38,8 @@ SurfaceGame::SurfaceGame(QWidget *pParent) :
 	pTimerResize(nullptr),
 	ubResizeCount(0u),
 	bLevelDone(false),
-	bLevelLoading(true),
 	bProtectPP(false),
+	pBoard(nullptr),
 	pAS(AppSettings::pAppSettings()),
 	pDialogLoad(nullptr),
 	pStartCountDownFrame(nullptr),
@@ -106,6 +107,14 @@ void SurfaceGame::changeEvent(QEvent *pEvent) {
 // set all to 0
 void SurfaceGame::clearSurface() {
 
+	if (this->pBoard) {
+
+		this->pBoard->clear();
+
+		return;
+
+	} // if one widget
+
 	quint8 ubRows = quint8(this->aopRows.count());
 	quint8 ubColumns = quint8(this->aopRows.first().count());
 	quint8 ubX = 0u;
@@ -146,6 +155,16 @@ void SurfaceGame::clearSurfaceOf(const quint8 ubState) {
 
 void SurfaceGame::clearSurfaceOf(const QVector<quint8> aStates) {
 
+	if (this->pBoard) {
+
+		for (int iCell = 0; iCell < this->pBoard->cellCount(); ++iCell)
+			if (aStates.contains(this->pBoard->state(iCell)))
+				this->pBoard->defrostState(iCell);
+
+		return;
+
+	} // if one widget
+
 	quint8 ubRows = quint8(this->aopRows.count());
 	quint8 ubColumns = quint8(this->aopRows.first().count());
 	quint8 ubX = 0u;
@@ -176,6 +195,49 @@ void SurfaceGame::clearSurfaceOf(const QVector<quint8> aStates) {
 } // clearSurfaceOf(vector)
 
 
+// like clearSurfaceOf(vector) for all states in any of ubClasses, see L::TileClass
+void SurfaceGame::clearSurfaceOfClass(const quint8 ubClasses) {
+
+	if (this->pBoard) {
+
+		for (int iCell = 0; iCell < this->pBoard->cellCount(); ++iCell)
+			if (L::isTile(this->pBoard->state(iCell), ubClasses))
+				this->pBoard->defrostState(iCell);
+
+		return;
+
+	} // if one widget
+
+	quint8 ubRows = quint8(this->aopRows.count());
+	quint8 ubColumns = quint8(this->aopRows.first().count());
+	quint8 ubX = 0u;
+	quint8 ubY = 0u;
+	QList<SurfaceCell*> aRow;
+	SurfaceCell *pCell;
+
+	for (ubY = 0u; ubY < ubRows; ubY++) {
+
+		aRow = this->aopRows.at(ubY);
+
+		for (ubX = 0u; ubX < ubColumns; ubX++) {
+
+			pCell = aRow.at(ubX);
+
+			if (L::isTile(pCell->getState(), ubClasses)) {
+
+				pCell->defrostState();
+
+			} // if one to clear
+
+		} // loop columns
+
+	} // loop rows
+
+	this->update();
+
+} // clearSurfaceOfClass
+
+
 void SurfaceGame::clearSurfaceOfWorm(const quint8 ubWormColourIndex) {
 
 	this->clearSurfaceOf(IconEngine::statesSnake(ubWormColourIndex));
@@ -185,7 +247,7 @@ void SurfaceGame::clearSurfaceOfWorm(const quint8 ubWormColourIndex) {
 
 void SurfaceGame::clearSurfaceOfWorms() {
 
-	this->clearSurfaceOf(IconEngine::statesSnakes());
+	this->clearSurfaceOfClass(L::ClassSnake);
 
 } // clearSurfaceOfWorms
 
@@ -232,11 +294,25 @@ void SurfaceGame::countdownTick() {
 
 Map *SurfaceGame::currentMap() {
 
-	quint8 ubRows = quint8(this->aopRows.count());
-	quint8 ubColumns = quint8(this->aopRows.first().count());
 	quint8 ubX = 0u;
 	quint8 ubY = 0u;
 
+	if (this->pBoard) {
+
+		Map *pMap = new Map(this->pBoard->columns(), this->pBoard->rows(), this);
+
+		for (ubY = 0u; ubY < this->pBoard->rows(); ubY++)
+			for (ubX = 0u; ubX < this->pBoard->columns(); ubX++)
+				pMap->setTile(ubX, ubY, this->pBoard->state(
+								  this->pBoard->cellIndex(QPoint(ubX, ubY))));
+
+		return pMap;
+
+	} // if one widget
+
+	quint8 ubRows = quint8(this->aopRows.count());
+	quint8 ubColumns = quint8(this->aopRows.first().count());
+
 	Map *pMap = new Map(ubColumns, ubRows, this);
 
 	for (ubY = 0u; ubY < ubRows; ubY++) {
@@ -354,6 +430,24 @@ void SurfaceGame::initCells() {
 
 	pVBox->setSpacing(0);
 
+	if (!this->pAS->get(AppSettings::sSettingGameCellWidgets).toBool()) {
+
+		this->pBoard = new SurfaceBoard(SssS_Nibblers_Surface_Width,
+										SssS_Nibblers_Surface_Height, this);
+
+		connect(this, SIGNAL(trailChanged(int)),
+				this->pBoard, SLOT(onTrailChanged(int)));
+
+		this->pBoard->setCursor(Qt::BlankCursor);
+		this->pBoard->onTrailChanged(uiTrail);
+
+		pVBox->addWidget(this->pBoard);
+		this->pUi->frameSurface->setLayout(pVBox);
+
+		return;
+
+	} // if one widget for all tiles
+
 	for (; ubRows < SssS_Nibblers_Surface_Height; ++ubRows) {
 
 		aRow.clear();
@@ -372,9 +466,6 @@ void SurfaceGame::initCells() {
 			connect(pCell, SIGNAL(debugMessage(QString)),
 					this, SLOT(onDebugMessage(QString)));
 
-			connect(pCell, SIGNAL(changed(QPoint,quint8)),
-					this, SLOT(onCellChanged(QPoint,quint8)));
-
 			pCell->setCursor(Qt::BlankCursor);
 
 			pCell->onTrailChanged(uiTrail);
@@ -434,6 +525,8 @@ void SurfaceGame::keyPressEvent(QKeyEvent *pEvent) {
 
 	//this->onDebugMessage("keyPressEvent");
 
+	SssS_Nibblers_Trace_Span(PhaseInput);
+
 	QKeySequence oKSin(pEvent->key());
 
 	quint8 ubWorm;
@@ -479,41 +572,6 @@ void SurfaceGame::mousePressEvent(QMouseEvent *pEvent) {
 } // mousePressEvent
 
 
-void SurfaceGame::onAdvanceWormTo(Worm *pWorm, const QPoint oPoint) {
-
-	pWorm->advanceTo(this->getCell(oPoint));
-
-} // onAdvanceWormTo
-
-
-void SurfaceGame::onBonusPlaced(const QVector<QPoint> aoPoints,
-								const quint8 ubBonus, const bool bFake) {
-
-	//this->onDebugMessage("onBonusPlaced");
-	//this->onDebugMessage(QString::number(ubBonus) + " " + QString::number(aoPoints.at(0).x()) + ":" + QString::number(aoPoints.at(0).y()) + " " + QString::number(bFake));
-
-	SurfaceCell *pCell = this->getCell(aoPoints.first());
-	SurfaceCell *pCell1 = this->getCell(aoPoints.at(1));
-	SurfaceCell *pCell2 = this->getCell(aoPoints.at(2));
-	SurfaceCell *pCell3 = this->getCell(aoPoints.last());
-
-	this->setCellState(pCell, ubBonus);
-	this->setCellState(pCell1, ubBonus + 1u);
-	this->setCellState(pCell2, ubBonus + 2u);
-	this->setCellState(pCell3, ubBonus + 3u);
-
-	QVector<SurfaceCell *> apCells;
-	apCells.clear();
-	apCells.append(pCell);
-	apCells.append(pCell1);
-	apCells.append(pCell2);
-	apCells.append(pCell3);
-
-	Q_EMIT this->bonusPlaced(apCells, bFake);
-
-} // onBonusPlaced
-
-
 void SurfaceGame::on_buttonPP_toggled(bool bStartPlaying) {
 
 	this->pUi->buttonPP->setText(bStartPlaying ? tr("Pause") : tr("Play"));
@@ -689,8 +747,6 @@ void SurfaceGame::onLoadLevel(MapGame *pMap, const quint8 ubLevel) {
 
 	this->onDebugMessage("onLoadLevel");
 
-	this->bLevelLoading = true;
-
 	this->ubCurrentLevel = ubLevel;
 
 	this->pUi->labelLevel->setText(tr("Level") + " " + QString::number(ubLevel));
@@ -699,12 +755,23 @@ void SurfaceGame::onLoadLevel(MapGame *pMap, const quint8 ubLevel) {
 
 	quint8 ubColumns = 0u;
 	quint8 ubRows = 0u;
+	int iCell;
 	SurfaceCell *pCell;
 
 	for (; ubRows < SssS_Nibblers_Surface_Height; ++ubRows) {
 
 		for (ubColumns = 0u; ubColumns < SssS_Nibblers_Surface_Width; ++ubColumns) {
 
+			if (this->pBoard) {
+
+				iCell = this->pBoard->cellIndex(QPoint(ubColumns, ubRows));
+				this->pBoard->setState(iCell, pMap->tile(ubColumns, ubRows));
+				this->pBoard->freezeState(iCell);
+
+				continue;
+
+			} // if one widget
+
 			pCell = this->getCell(ubColumns, ubRows);
 
 			this->setCellState(pCell, pMap->tile(ubColumns, ubRows), false);
@@ -717,10 +784,6 @@ void SurfaceGame::onLoadLevel(MapGame *pMap, const quint8 ubLevel) {
 
 	this->update();
 
-	this->bLevelLoading = false;
-
-	Q_EMIT this->levelIsLoaded();
-
 } // onLoadLevel
 
 
@@ -789,19 +852,54 @@ void SurfaceGame::onQuitting() {
 } // onQuitting
 
 
-void SurfaceGame::onSpawnWorm(Worm *pWorm) {
+void SurfaceGame::onTilesChanged(const QVector<TileChange> &aoChanges) {
+
+	SssS_Nibblers_Trace_Span(PhaseRender);
 
-	//this->onDebugMessage("onSpawnWorm");
+	if (this->pBoard) {
 
-	pWorm->startSpawning();
+		this->pBoard->onTilesChanged(aoChanges);
+
+		return;
 
-	pWorm->advanceTo(this->getCell(pWorm->spawnPoint()));
-	pWorm->advanceTo(this->getCell(pWorm->nextPoint()));
-	pWorm->advanceTo(this->getCell(pWorm->nextPoint()));
-	pWorm->advanceTo(this->getCell(pWorm->nextPoint()));
-	pWorm->advanceTo(this->getCell(pWorm->nextPoint()));
+	} // if one widget
+
+	if (this->aopRows.isEmpty()) return;
+
+	const int iColumns = this->aopRows.first().count();
+	SurfaceCell *pCell;
 
-} // onSpawnWorm
+	for (int i = 0; i < aoChanges.length(); ++i) {
+
+		const TileChange &oChange = aoChanges.at(i);
+
+		pCell = this->getCell(quint8(oChange.uiCell % iColumns),
+							  quint8(oChange.uiCell / iColumns));
+		if (pCell->isNull()) continue;
+
+		// worm's tail moved on, let cell fade back to original state
+		if (oChange.bTrail) {
+
+			pCell->desnakeState();
+
+			continue;
+
+		} // if trail
+
+		// back to original state
+		if (pCell->getStateFrozen() == oChange.ubNew) {
+
+			pCell->defrostState();
+
+			continue;
+
+		} // if defrosted
+
+		this->setCellState(pCell, oChange.ubNew);
+
+	} // loop changes
+
+} // onTilesChanged
 
 
 void SurfaceGame::onWormAteBonus(Worm *pWorm) {
@@ -809,7 +907,14 @@ void SurfaceGame::onWormAteBonus(Worm *pWorm) {
 	//this->onDebugMessage("onWormAteBonus");
 
 	// mark bloatedness on worm
-	pWorm->headCell()->addBloatedHeading(pWorm->currentDirection());
+	if (this->pBoard) {
+
+		if (this->pBoard->contains(pWorm->headPoint()))
+			this->pBoard->addBloatedHeading(
+						this->pBoard->cellIndex(pWorm->headPoint()),
+						pWorm->currentDirection());
+
+	} else this->getCell(pWorm->headPoint())->addBloatedHeading(pWorm->currentDirection());
 
 	// this should be dealt with by Worm automatically
 	//pWorm->setNextBloatHeading(L::oppositeHeading(pWorm->currentDirection()));
@@ -817,13 +922,6 @@ void SurfaceGame::onWormAteBonus(Worm *pWorm) {
 } // onWormAteBonus
 
 
-void SurfaceGame::onWormCrashed(Worm *pWorm) {
-
-	this->clearSurfaceOfWorm(pWorm->colourIndex());
-
-} // onWormCrashed
-
-
 void SurfaceGame::onWormCreated(Worm *pWorm) {
 
 	this->apWorms.append(pWorm);
@@ -944,6 +1042,14 @@ void SurfaceGame::resizeEvent(QResizeEvent *pEvent) {
 void SurfaceGame::setCellState(const QPoint oPoint, const quint8 ubState,
 							   const bool bUpdate) {
 
+	if (this->pBoard) {
+
+		this->setCellState(quint8(oPoint.x()), quint8(oPoint.y()), ubState, bUpdate);
+
+		return;
+
+	} // if one widget
+
 	SurfaceCell *pCell = this->getCell(oPoint);
 	if (pCell->isNull()) return;
 
@@ -971,6 +1077,17 @@ void SurfaceGame::setCellState(SurfaceCell *pCell, const quint8 ubState,
 void SurfaceGame::setCellState(const quint8 ubColumn, const quint8 ubRow,
 								  const quint8 ubState, const bool bUpdate) {
 
+	// damage tracking makes bUpdate moot
+	if (this->pBoard) {
+
+		if (this->pBoard->contains(QPoint(ubColumn, ubRow)))
+			this->pBoard->setState(this->pBoard->cellIndex(QPoint(ubColumn, ubRow)),
+								   ubState);
+
+		return;
+
+	} // if one widget
+
 	// check limits
 	if (ubRow >= this->aopRows.count()) return;
 	if (ubColumn >= this->aopRows.first().count()) return;
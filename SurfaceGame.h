@@ -28,6 +28,7 @@
 #include "Map.h"
 #include "MapGame.h"
 #include "ScoreBoard.h"
+#include "SurfaceBoard.h"
 #include "SurfaceCell.h"
 #include "Worm.h"
 
@@ -63,9 +64,10 @@ private slots:
 
 protected:
 	bool bLevelDone;
-	bool bLevelLoading;
 	bool bProtectPP;
+	// empty when pBoard draws the tiles, see AppSettings::sSettingGameCellWidgets
 	QList<QList<SurfaceCell *> > aopRows;
+	SurfaceBoard *pBoard;
 	QVector<ScoreBoard *> apScoreBoards;
 	QVector<Worm *> apWorms;
 	QVector<QHash<QKeySequence, L::Heading>> ahKeys;
@@ -80,6 +82,7 @@ protected:
 	virtual void clearSurface();
 	virtual void clearSurfaceOf(const quint8 ubState);
 	virtual void clearSurfaceOf(const QVector<quint8>aStates);
+	virtual void clearSurfaceOfClass(const quint8 ubClasses);
 	virtual void clearSurfaceOfWorm(const quint8 ubWormColourIndex);
 	virtual void clearSurfaceOfWorms();
 	virtual Map *currentMap();
@@ -117,29 +120,19 @@ public:
 	virtual QSize sizeHint() const override;
 
 signals:
-	void bonusPlaced(QVector<SurfaceCell *> apCells, const bool bFake) const;
 	void debugMessage(const QString &sMessage) const;
-	void levelIsLoaded() const;
 	void nextLevel() const;
 	void pauseResumeToggled() const;
 	void resetGame(const bool bInvalidateWorms) const;
 	void startNewGame(const quint8 ubLevel) const;
 	void statusMessage(const QString &sMessage) const;
-	void tileChanged(const QPoint oPoint, const quint8 ubState) const;
 	void trailChanged(const int iValue) const;
 	void turnWorm(const quint8 ubWorm, const L::Heading eDirection) const;
 
 public slots:
-	virtual void onAdvanceWormTo(Worm *pWorm, const QPoint oPoint);
-	virtual void onBonusPlaced(const QVector<QPoint> aoPoints,
-							   const quint8 ubBonus, const bool bFake);
-
 	inline void onDebugMessage(const QString &sMessage) const {
 		Q_EMIT this->debugMessage("SG:" + sMessage); }
 
-	inline void onCellChanged(const QPoint oPoint, const quint8 ubState) const {
-		if (!this->bLevelLoading) Q_EMIT this->tileChanged(oPoint, ubState); }
-
 	virtual void onColoursChanged(const QVector<quint8> aubColours);
 	virtual void onDoGameOver(const QString &sRanking);
 	virtual void onDoLevelDone();
@@ -156,12 +149,11 @@ public slots:
 	virtual void onPlayerRelativeChanged(const quint8 ubWorm, const bool bRelative);
 	inline virtual void onPlayerUseMouseChanged() { this->initKeys(); }
 	virtual void onQuitting();
-	virtual void onSpawnWorm(Worm *pWorm);
+	virtual void onTilesChanged(const QVector<TileChange> &aoChanges);
 	inline virtual void onTrailChanged(const int iValue) {
 		Q_EMIT this->trailChanged(iValue); }
 
 	virtual void onWormAteBonus(Worm *pWorm);
-	virtual void onWormCrashed(Worm *pWorm);
 	virtual void onWormCreated(Worm *pWorm);
 	virtual void onWormsInvalidated();
 
@@ -0,0 +1,316 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Tournament.h"
+
+#include "AppSettings.h"
+#include "GameHeadless.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QMap>
+#include <QThread>
+#include <QThreadPool>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+TournamentWorker::TournamentWorker(Tournament *pTournament) :
+	QRunnable(),
+	pTournament(pTournament) {
+
+} // construct
+
+
+void TournamentWorker::run() {
+
+	this->pTournament->playMatches();
+
+} // run
+
+
+
+Tournament::Tournament(QObject *pParent) :
+	QObject(pParent),
+	iThreads(QThread::idealThreadCount()),
+	illElapsed(0),
+	ulTicksMax(0u),
+	oNextMatch(0),
+	pResults(nullptr) {
+
+	if (1 > this->iThreads) this->iThreads = 1;
+
+	this->clearMatches();
+	this->hSettings.clear();
+
+	// every key Game reads, so workers never fall back to AppSettings
+	// searching AI goes by depth only, so matches can be played again
+	this->setSetting(AppSettings::sSettingGameAIBudget, 0u);
+	this->setSetting(AppSettings::sSettingGameAILookahead,
+					 uint(AppSettings::ubSettingGameAILookaheadDefault));
+	this->setSetting(AppSettings::sSettingGameBadLevelMode,
+					 uint(AppSettings::ubSettingGameBadLevelModeDefault));
+	this->setSetting(AppSettings::sSettingGameCountAIs,
+					 uint(AppSettings::ubSettingGameCountAIsDefault));
+	this->setSetting(AppSettings::sSettingGameCountHumans, 0u);
+	this->setSetting(AppSettings::sSettingGameFakeBonuses, false);
+	this->setSetting(AppSettings::sSettingGameLimitLives, false);
+	this->setSetting(AppSettings::sSettingGameOverOnLastDead, false);
+	// matches already keep all threads busy
+	this->setSetting(AppSettings::sSettingGameParallelAI, false);
+	this->setSetting(AppSettings::sSettingGameSpeed, 3);
+	this->setSetting(AppSettings::sSettingGameStartLevel,
+					 uint(AppSettings::ubSettingGameStartLevelDefault));
+	this->setSetting(AppSettings::sSettingGameStartLives,
+					 uint(AppSettings::ubSettingGameStartLivesDefault));
+
+} // construct
+
+
+Tournament::~Tournament() {
+
+	this->clearMatches();
+	this->hSettings.clear();
+
+} // dealloc
+
+
+void Tournament::addMatch(const quint8 ubLevel, const quint8 ubCountAIs,
+						  const quint32 ulSeed) {
+
+	this->aubMatchAIs.append(ubCountAIs);
+	this->aubMatchLevels.append(ubLevel);
+	this->aulMatchSeeds.append(ulSeed);
+
+} // addMatch
+
+
+void Tournament::clearMatches() {
+
+	this->aubMatchAIs.clear();
+	this->aubMatchLevels.clear();
+	this->aulMatchSeeds.clear();
+	this->aoResults.clear();
+	this->pResults = nullptr;
+
+} // clearMatches
+
+
+// runs in pool threads
+void Tournament::playMatches() {
+
+	// created in this thread, so are its MapGame and WormAI
+	GameHeadless *pGame = new GameHeadless();
+
+	QHash<QString, QVariant>::const_iterator i;
+	for (i = this->hSettings.constBegin(); i != this->hSettings.constEnd(); ++i)
+		pGame->setSetting(i.key(), i.value());
+
+	pGame->setLevelPath(this->sPathLevels);
+	pGame->setTicksMax(this->ulTicksMax);
+	pGame->init();
+
+	const int iCount = this->matchCount();
+	int iMatch;
+	QJsonArray aWorms;
+	QJsonObject oResult;
+	QVector<HistoryItem *> apResults;
+	while (iCount > (iMatch = this->oNextMatch.fetchAndAddRelaxed(1))) {
+
+		pGame->setSeed(this->aulMatchSeeds.at(iMatch));
+
+		pGame->setSetting(AppSettings::sSettingGameCountAIs,
+						  uint(this->aubMatchAIs.at(iMatch)));
+
+		pGame->playGame(this->aubMatchLevels.at(iMatch));
+
+		aWorms = QJsonArray();
+		apResults = pGame->results();
+		for (int j = 0; j < apResults.length(); ++j)
+			aWorms.append(apResults.at(j)->toJSON());
+
+		oResult = QJsonObject();
+		oResult.insert("match", iMatch);
+		oResult.insert("level", this->aubMatchLevels.at(iMatch));
+		oResult.insert("ais", this->aubMatchAIs.at(iMatch));
+		oResult.insert("seed", qint64(this->aulMatchSeeds.at(iMatch)));
+		oResult.insert("ticks", qint64(pGame->ticks()));
+		oResult.insert("won", pGame->isWon());
+		oResult.insert("stalled", pGame->isTimedOut());
+		oResult.insert("aborted", pGame->isAborted());
+		oResult.insert("worms", aWorms);
+
+		this->pResults[iMatch] = oResult;
+
+	} // loop until no match is left
+
+	delete pGame;
+
+} // playMatches
+
+
+bool Tournament::run() {
+
+	const int iCount = this->matchCount();
+
+	this->aoResults.clear();
+	this->aoResults.resize(iCount);
+	// detach here, workers only write to their own slots
+	this->pResults = this->aoResults.data();
+	this->oNextMatch.store(0);
+
+	QThreadPool oPool;
+	oPool.setMaxThreadCount(this->iThreads);
+
+	QElapsedTimer oTimer;
+	oTimer.start();
+
+	int iWorker;
+	for (iWorker = 0; iWorker < qMin(this->iThreads, iCount); ++iWorker)
+		oPool.start(new TournamentWorker(this));
+
+	oPool.waitForDone();
+
+	this->illElapsed = oTimer.elapsed();
+	this->pResults = nullptr;
+
+	for (int i = 0; i < iCount; ++i) {
+
+		if (this->aoResults.at(i).value("aborted").toBool()) return false;
+
+	} // loop results
+
+	return true;
+
+} // run
+
+
+QJsonObject Tournament::statistics(const QVector<int> aiMatches) const {
+
+	double dLevelsDone = 0.0;
+	double dLivesLost = 0.0;
+	double dScore = 0.0;
+	double dTicks = 0.0;
+	int iAborted = 0;
+	int iStalled = 0;
+	int iWon = 0;
+	int iWorms = 0;
+
+	QJsonArray aWorms;
+	QJsonObject oResult;
+	QJsonObject oWorm;
+	for (int i = 0; i < aiMatches.length(); ++i) {
+
+		oResult = this->aoResults.at(aiMatches.at(i));
+
+		if (oResult.value("aborted").toBool()) {
+
+			++iAborted;
+			continue;
+
+		} // if not played
+
+		if (oResult.value("stalled").toBool()) ++iStalled;
+		if (oResult.value("won").toBool()) ++iWon;
+		dTicks += oResult.value("ticks").toDouble();
+
+		aWorms = oResult.value("worms").toArray();
+		for (int j = 0; j < aWorms.count(); ++j) {
+
+			oWorm = aWorms.at(j).toObject();
+			dLevelsDone += oWorm.value("levelsDone").toDouble();
+			dLivesLost += oWorm.value("livesLost").toDouble();
+			dScore += oWorm.value("score").toDouble();
+			++iWorms;
+
+		} // loop worms
+
+	} // loop matches
+
+	int iPlayed = aiMatches.length() - iAborted;
+
+	QJsonObject oStats;
+	oStats.insert("games", aiMatches.length());
+	oStats.insert("aborted", iAborted);
+	oStats.insert("stalled", iStalled);
+	oStats.insert("won", iWon);
+	oStats.insert("ticksMean", iPlayed ? dTicks / iPlayed : 0.0);
+	oStats.insert("scoreMean", iWorms ? dScore / iWorms : 0.0);
+	oStats.insert("levelsDoneMean", iWorms ? dLevelsDone / iWorms : 0.0);
+	oStats.insert("livesLostMean", iWorms ? dLivesLost / iWorms : 0.0);
+
+	return oStats;
+
+} // statistics
+
+
+QJsonObject Tournament::summary() const {
+
+	QVector<int> aiAll;
+	QMap<int, QVector<int>> haiLevels;
+	QMap<QString, QVector<int>> haiConfigurations;
+
+	quint8 ubLevel;
+	for (int i = 0; i < this->aoResults.length(); ++i) {
+
+		ubLevel = this->aubMatchLevels.at(i);
+
+		aiAll.append(i);
+		haiLevels[ubLevel].append(i);
+		haiConfigurations[QString::number(ubLevel) + "x"
+				+ QString::number(this->aubMatchAIs.at(i))].append(i);
+
+	} // loop results
+
+	QJsonObject oLevels;
+	QMap<int, QVector<int>>::const_iterator iLevel;
+	for (iLevel = haiLevels.constBegin(); iLevel != haiLevels.constEnd(); ++iLevel)
+		oLevels.insert(QString::number(iLevel.key()), this->statistics(iLevel.value()));
+
+	QJsonObject oConfigurations;
+	QMap<QString, QVector<int>>::const_iterator iConfiguration;
+	for (iConfiguration = haiConfigurations.constBegin();
+		 iConfiguration != haiConfigurations.constEnd(); ++iConfiguration)
+		oConfigurations.insert(iConfiguration.key(),
+							   this->statistics(iConfiguration.value()));
+
+	double dTicks = 0.0;
+	for (int i = 0; i < this->aoResults.length(); ++i)
+		dTicks += this->aoResults.at(i).value("ticks").toDouble();
+
+	double dSeconds = double(this->illElapsed) / 1000.0;
+
+	QJsonObject oSummary;
+	oSummary.insert("threads", this->iThreads);
+	oSummary.insert("elapsedMs", qint64(this->illElapsed));
+	oSummary.insert("gamesPerSecond",
+					(0.0 < dSeconds) ? this->aoResults.length() / dSeconds : 0.0);
+	oSummary.insert("ticksPerSecond", (0.0 < dSeconds) ? dTicks / dSeconds : 0.0);
+	oSummary.insert("all", this->statistics(aiAll));
+	oSummary.insert("levels", oLevels);
+	oSummary.insert("configurations", oConfigurations);
+
+	return oSummary;
+
+} // summary
+
+
+
+}	} // namespace SwissalpS::QtNibblers
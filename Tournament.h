@@ -0,0 +1,119 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QRunnable>
+#include <QVariant>
+#include <QVector>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+class Tournament;
+
+
+
+// runs in a pool thread, see Tournament::playMatches()
+class TournamentWorker : public QRunnable {
+
+private:
+	Tournament *pTournament;
+
+public:
+	explicit TournamentWorker(Tournament *pTournament);
+	virtual void run() override;
+
+}; // TournamentWorker
+
+
+
+// Plays a list of independent matches (level x AI count x seed) on
+// several threads. Every worker thread owns one GameHeadless and with it
+// its own MapGame and WormAI. Workers claim the next unplayed match from
+// a shared counter, so threads that drew short matches simply claim more.
+class Tournament : public QObject {
+
+	Q_OBJECT
+
+	friend class TournamentWorker;
+
+private:
+
+protected:
+	int iThreads;
+	qint64 illElapsed;
+	quint32 ulTicksMax;
+	QAtomicInt oNextMatch;
+	QString sPathLevels;
+	QVector<quint8> aubMatchAIs;
+	QVector<quint8> aubMatchLevels;
+	QVector<quint32> aulMatchSeeds;
+	QVector<QJsonObject> aoResults;
+	// only written to by workers, one slot per match
+	QJsonObject *pResults;
+	// read only while matches are being played
+	QHash<QString, QVariant> hSettings;
+
+	virtual void playMatches();
+	virtual QJsonObject statistics(const QVector<int> aiMatches) const;
+
+public:
+	explicit Tournament(QObject *pParent = nullptr);
+	virtual ~Tournament() override;
+
+	virtual void addMatch(const quint8 ubLevel, const quint8 ubCountAIs,
+						  const quint32 ulSeed);
+
+	virtual void clearMatches();
+	inline virtual qint64 elapsed() const { return this->illElapsed; }
+	inline virtual int matchCount() const { return this->aubMatchLevels.length(); }
+	inline virtual QJsonObject result(const int iMatch) const {
+		return this->aoResults.value(iMatch); }
+
+	// plays all matches, blocks until done. Returns false if any match
+	// could not be played (e.g. level lacks spawn points)
+	virtual bool run();
+	// directory containing Level_N files, needs trailing slash
+	inline virtual void setLevelPath(const QString sPath) { this->sPathLevels = sPath; }
+	// applied to every game, see GameHeadless::setSetting()
+	inline virtual void setSetting(const QString &sKey, const QVariant &mValue) {
+		this->hSettings.insert(sKey, mValue); }
+
+	inline virtual void setThreads(const int iCount) { this->iThreads = qMax(1, iCount); }
+	inline virtual void setTicksMax(const quint32 ulTicks) { this->ulTicksMax = ulTicks; }
+	// per level, per configuration and overall statistics of last run
+	virtual QJsonObject summary() const;
+	inline virtual int threads() const { return this->iThreads; }
+
+}; // Tournament
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,164 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Trace.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QVector>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// names of Trace::Phase in the dump
+static const char *aszPhaseNames[] = {
+	"Tick", "Input", "AI", "Movement", "Collision", "Bonus", "Render",
+	"AI plan", "Cell event"
+};
+
+// every buffer ever handed out, they live as long as the process
+static QMutex oMutexBuffers;
+static QVector<Trace::Buffer *> apBuffers;
+static thread_local Trace::Buffer *pBufferOfThread = nullptr;
+
+
+static QElapsedTimer startedClock() {
+
+	QElapsedTimer oClock;
+	oClock.start();
+
+	return oClock;
+
+} // startedClock
+
+
+Trace::Buffer *Trace::buffer() {
+
+	if (pBufferOfThread) return pBufferOfThread;
+
+	// only the first record of each thread gets here
+	Buffer *pBuffer = new Buffer;
+	pBuffer->ulTick = 0u;
+
+	QMutexLocker oLocker(&oMutexBuffers);
+	pBuffer->ulThread = quint32(apBuffers.length());
+	apBuffers.append(pBuffer);
+
+	pBufferOfThread = pBuffer;
+
+	return pBuffer;
+
+} // buffer
+
+
+qint64 Trace::now() {
+
+	static const QElapsedTimer oClock = startedClock();
+
+	return oClock.nsecsElapsed();
+
+} // now
+
+
+void Trace::onTick() {
+
+	buffer()->ulTick++;
+
+} // onTick
+
+
+void Trace::record(const Phase ePhase, const qint64 illStart,
+				   const qint64 illDuration, const quint32 ulArgument) {
+
+	Buffer *pBuffer = buffer();
+	const quint32 ulWritten = pBuffer->ulWritten.loadAcquire();
+	Record &oRecord = pBuffer->aoRecords[ulWritten & (SssS_Nibblers_Trace_Records - 1u)];
+
+	oRecord.illStart = illStart;
+	oRecord.illDuration = illDuration;
+	oRecord.ulTick = pBuffer->ulTick;
+	oRecord.ulArgument = ulArgument;
+	oRecord.ubPhase = quint8(ePhase);
+
+	// oldest record is overwritten once the ring is full
+	pBuffer->ulWritten.storeRelease(ulWritten + 1u);
+
+} // record
+
+
+bool Trace::writeChromeTrace(const QString sFilePath) {
+
+	QFile oFile(sFilePath);
+	if (!oFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+	QTextStream oOut(&oFile);
+	QMutexLocker oLocker(&oMutexBuffers);
+	Buffer *pBuffer;
+	bool bFirst = true;
+	quint32 ulFirst;
+	quint32 ulWritten;
+
+	// Chrome wants microseconds, keep nanoseconds
+	oOut.setRealNumberNotation(QTextStream::FixedNotation);
+	oOut.setRealNumberPrecision(3);
+
+	oOut << "{\"traceEvents\":[";
+
+	for (int i = 0; i < apBuffers.length(); ++i) {
+
+		pBuffer = apBuffers.at(i);
+		ulWritten = pBuffer->ulWritten.loadAcquire();
+		ulFirst = (SssS_Nibblers_Trace_Records < ulWritten)
+				  ? ulWritten - SssS_Nibblers_Trace_Records : 0u;
+
+		for (quint32 ul = ulFirst; ul < ulWritten; ++ul) {
+
+			const Record &oRecord = pBuffer->aoRecords[ul & (SssS_Nibblers_Trace_Records - 1u)];
+
+			if (!bFirst) oOut << ",";
+			bFirst = false;
+
+			oOut << "\n{\"name\":\"" << aszPhaseNames[oRecord.ubPhase]
+				 << "\",\"pid\":1,\"tid\":" << pBuffer->ulThread
+				 << ",\"ts\":" << (double(oRecord.illStart) / 1000.0);
+
+			if (0 > oRecord.illDuration) oOut << ",\"ph\":\"i\",\"s\":\"t\"";
+			else oOut << ",\"ph\":\"X\",\"dur\":" << (double(oRecord.illDuration) / 1000.0);
+
+			oOut << ",\"args\":{\"tick\":" << oRecord.ulTick
+				 << ",\"argument\":" << oRecord.ulArgument << "}}";
+
+		} // loop records
+
+	} // loop buffers
+
+	oOut << "\n]}\n";
+	oOut.flush();
+
+	return QTextStream::Ok == oOut.status();
+
+} // writeChromeTrace
+
+
+
+}	} // namespace SwissalpS::QtNibblers
@@ -0,0 +1,140 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "definitions.h"
+
+#include <QAtomicInteger>
+#include <QString>
+#include <QtGlobal>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// Spans and events go to a ring buffer of the thread they happen on, one
+// fixed-size record each, so tracing costs no locks, strings or signals.
+// Use the macros below, they vanish unless SssS_Nibblers_Trace_Level is
+// high enough. writeChromeTrace() dumps what is left in the buffers.
+class Trace {
+
+public:
+	// what a record is about, also its name in the dump
+	enum Phase {
+		PhaseTick = 0u,
+		PhaseInput = 1u,
+		PhaseAI = 2u,
+		PhaseMovement = 3u,
+		PhaseCollision = 4u,
+		PhaseBonus = 5u,
+		PhaseRender = 6u,
+		PhaseAIPlan = 7u,
+		PhaseCellEvent = 8u
+	};
+
+	struct Record {
+		qint64 illStart;
+		// nanoseconds, -1 for an instant
+		qint64 illDuration;
+		quint32 ulTick;
+		quint32 ulArgument;
+		quint8 ubPhase;
+	};
+
+	// what one thread has written, only that thread writes to it
+	struct Buffer {
+		Record aoRecords[SssS_Nibblers_Trace_Records];
+		QAtomicInteger<quint32> ulWritten;
+		quint32 ulThread;
+		quint32 ulTick;
+	};
+
+private:
+	static Buffer *buffer();
+
+public:
+	// nanoseconds since tracing started
+	static qint64 now();
+	// counts ticks of the calling thread, later records carry the count
+	static void onTick();
+	static void record(const Phase ePhase, const qint64 illStart,
+					   const qint64 illDuration, const quint32 ulArgument = 0u);
+	// Chrome trace JSON of all buffers, call while nothing is traced
+	static bool writeChromeTrace(const QString sFilePath);
+
+}; // Trace
+
+
+
+// records the time from construction to going out of scope
+class TraceSpan {
+
+private:
+	qint64 illStart;
+	quint32 ulArgument;
+	Trace::Phase ePhase;
+
+public:
+	explicit TraceSpan(const Trace::Phase ePhase, const quint32 ulArgument = 0u) :
+		illStart(Trace::now()), ulArgument(ulArgument), ePhase(ePhase) {}
+	inline ~TraceSpan() {
+		Trace::record(this->ePhase, this->illStart,
+					  Trace::now() - this->illStart, this->ulArgument); }
+
+}; // TraceSpan
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#define SssS_Nibblers_Trace_Join2(a, b) a##b
+#define SssS_Nibblers_Trace_Join(a, b) SssS_Nibblers_Trace_Join2(a, b)
+
+#if 0 < SssS_Nibblers_Trace_Level
+// Begin and End of one ePhase in the same scope, for parts of a function
+#define SssS_Nibblers_Trace_Begin(ePhase) const qint64 illTrace##ePhase = \
+		SwissalpS::QtNibblers::Trace::now()
+#define SssS_Nibblers_Trace_End(ePhase) SwissalpS::QtNibblers::Trace::record( \
+		SwissalpS::QtNibblers::Trace::ePhase, illTrace##ePhase, \
+		SwissalpS::QtNibblers::Trace::now() - illTrace##ePhase)
+#define SssS_Nibblers_Trace_Tick() SwissalpS::QtNibblers::Trace::onTick()
+#define SssS_Nibblers_Trace_Span(ePhase) SwissalpS::QtNibblers::TraceSpan \
+		SssS_Nibblers_Trace_Join(oTraceSpan, __LINE__)(SwissalpS::QtNibblers::Trace::ePhase)
+#else
+#define SssS_Nibblers_Trace_Begin(ePhase)
+#define SssS_Nibblers_Trace_End(ePhase)
+#define SssS_Nibblers_Trace_Tick()
+#define SssS_Nibblers_Trace_Span(ePhase)
+#endif
+
+#if 1 < SssS_Nibblers_Trace_Level
+#define SssS_Nibblers_Trace_Detail(ePhase, ulArgument) SwissalpS::QtNibblers::Trace::record( \
+		SwissalpS::QtNibblers::Trace::ePhase, SwissalpS::QtNibblers::Trace::now(), -1, ulArgument)
+#define SssS_Nibblers_Trace_Detail_Span(ePhase, ulArgument) SwissalpS::QtNibblers::TraceSpan \
+		SssS_Nibblers_Trace_Join(oTraceSpan, __LINE__)(SwissalpS::QtNibblers::Trace::ePhase, ulArgument)
+#else
+#define SssS_Nibblers_Trace_Detail(ePhase, ulArgument)
+#define SssS_Nibblers_Trace_Detail_Span(ePhase, ulArgument)
+#endif
+
+#endif // TRACE_H
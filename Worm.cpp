@@ -25,7 +25,8 @@ namespace SwissalpS { namespace QtNibblers {
 
 
 Worm::Worm(const QPoint oPoint, const quint8 ubState, const quint8 ubColour,
-		   const bool bAI, const quint8 ubLivesMax, QObject *pParent) :
+		   const bool bAI, const quint8 ubLivesMax, MapGame *pMap,
+		   QObject *pParent) :
 	QObject(pParent),
 	bAmAI(bAI),
 	uiCountLevels(0u),
@@ -37,8 +38,11 @@ Worm::Worm(const QPoint oPoint, const quint8 ubState, const quint8 ubColour,
 	ubSpawnSafetyTicks(0u),
 	ulScore(0u),
 	oPointSpawn(oPoint),
-	sName("Worm"),
-	eNextBloat(L::Nowhere) {
+	pMap(pMap),
+	sName("Worm") {
+
+	if (pMap) this->oBody.setNeighbours(Map::neighbourTable(pMap->columns(),
+															 pMap->rows()));
 
 	this->onSetSpawnPoint(oPoint, ubState);
 
@@ -47,7 +51,8 @@ Worm::Worm(const QPoint oPoint, const quint8 ubState, const quint8 ubColour,
 
 Worm::~Worm() {
 
-	this->apCells.clear();
+	this->oBody.clear();
+	this->pMap = nullptr;
 
 } // dealloc
 
@@ -68,46 +73,37 @@ void Worm::addLength(int iLength) {
 
 	if (2u > this->uiTargetLength) this->uiTargetLength = 2u;
 
-	while (this->apCells.length() > this->uiTargetLength) {
+	while (this->oBody.length() > this->uiTargetLength) {
 
-		this->apCells.takeLast()->defrostState();
+		this->pMap->defrostTile(this->pMap->cellPoint(this->oBody.takeLast()));
 
 	} // loop away excess tail
 
-	this->tailCell()->setState(this->tailState());
+	this->pMap->setTile(this->tailPoint(), this->tailState());
 
 } // addLength
 
 
-void Worm::advanceTo(SurfaceCell *pCell) {
+void Worm::advanceTo(const QPoint oPoint) {
 
 	// make old head a mid-section
-	if (this->apCells.length())
-		this->apCells.first()->setState(this->midState());
-
-	if (L::Nowhere != this->eNextBloat) {
-
-		pCell->addBloatedHeading(this->eNextBloat);
-		this->eNextBloat = L::Nowhere;
-
-	} // if add bloat
+	if (this->oBody.length())
+		this->pMap->setTile(this->bodyPoint(0), this->midState());
 
 	// attach new head
-	this->apCells.prepend(pCell);
-	pCell->setState(this->headState());
-	pCell->update();
+	this->oBody.prepend(quint16(this->pMap->cellIndex(oPoint)));
+	this->pMap->setTile(oPoint, this->headState());
 
 	// remove any excess
-	while (this->uiTargetLength < this->apCells.length()) {
+	while (this->uiTargetLength < this->oBody.length()) {
 
-		// revert to normal game state
-		this->apCells.last()->desnakeState();
-		this->apCells.removeLast();
+		// revert to normal game state, leaving a trail
+		this->pMap->defrostTile(this->pMap->cellPoint(this->oBody.takeLast()), true);
 
 	} // loop
 
 	// make new tail
-	this->tailCell()->setState(this->tailState());
+	this->pMap->setTile(this->tailPoint(), this->tailState());
 
 	if (this->ubSpawnSafetyTicks) this->ubSpawnSafetyTicks--;
 
@@ -116,13 +112,13 @@ void Worm::advanceTo(SurfaceCell *pCell) {
 } // advanceTo
 
 
-SurfaceCell *Worm::assCell() {
+QPoint Worm::assPoint() const {
 
-	return this->uiTargetLength <= this->apCells.length()
-			? this->apCells.at(this->apCells.length() - 2)
-			: new SurfaceCell();
+	return this->uiTargetLength <= this->oBody.length()
+			? this->bodyPoint(this->oBody.length() - 2)
+			: QPoint(0xFFu, 0xFFu);
 
-} // assCell
+} // assPoint
 
 
 void Worm::doNextTurn() {
@@ -205,12 +201,12 @@ void Worm::doNextTurn() {
 } // doNextTurn
 
 
-SurfaceCell *Worm::headCell() {
+QPoint Worm::headPoint() const {
 
-	return this->apCells.length() ? this->apCells.first()
-								  : new SurfaceCell();
+	return this->oBody.length() ? this->bodyPoint(0)
+								: QPoint(0xFFu, 0xFFu);
 
-} // headCell
+} // headPoint
 
 
 L::Heading Worm::headingLeft() const {
@@ -259,30 +255,26 @@ L::Heading Worm::headingRight() const {
 
 QPoint Worm::leftPoint() {
 
-	if (0 == this->apCells.length()) return QPoint();
-
-	SurfaceCell *pCell = this->apCells.first();
+	if (0 == this->oBody.length()) return QPoint();
 
-	return L::warpPoint(pCell->getPos(), this->headingLeft());
+	return this->pMap->neighbourPoint(this->bodyPoint(0), this->headingLeft());
 
 } // leftPoint
 
 
-SurfaceCell *Worm::neckCell() {
+QPoint Worm::neckPoint() const {
 
-	return 1 < this->apCells.length() ? this->apCells.at(1)
-									  : new SurfaceCell();
+	return 1 < this->oBody.length() ? this->bodyPoint(1)
+									: QPoint(0xFFu, 0xFFu);
 
-} // neckCell
+} // neckPoint
 
 
 QPoint Worm::nextPoint() {
 
-	if (0 == this->apCells.length()) return QPoint();
+	if (0 == this->oBody.length()) return QPoint();
 
-	SurfaceCell *pCell = this->apCells.first();
-
-	return L::warpPoint(pCell->getPos(), this->eCurrentHeading);
+	return this->pMap->neighbourPoint(this->bodyPoint(0), this->eCurrentHeading);
 
 } // nextPoint
 
@@ -334,36 +326,29 @@ void Worm::onReverse() {
 
 	this->aeNextHeadings.clear();
 
-	QVector<SurfaceCell *> apOld(this->apCells);
-	this->apCells.clear();
-
-	while (apOld.length()) {
-
-		this->apCells.append(apOld.takeLast());
-
-	} // loop cells in backwards
+	this->oBody.reverse();
 
-	this->headCell()->setState(this->headState());
-	this->tailCell()->setState(this->tailState());
+	this->pMap->setTile(this->headPoint(), this->headState());
+	this->pMap->setTile(this->tailPoint(), this->tailState());
 
 	bool bSolveWithHeadOnly = false;
 	L::Heading eNewHeading = this->eCurrentHeading;
 
 	// check the first two segments to determine the heading
-	if (2 <= this->apCells.length()) {
+	if (2 <= this->oBody.length()) {
 
 		// try with the first 2 cells to find direction
-		eNewHeading = L::oppositeHeading(this->apCells.first()->getPos(),
-										 this->apCells.at(1)->getPos());
+		eNewHeading = L::oppositeHeading(this->bodyPoint(0),
+										 this->bodyPoint(1));
 
 		// did that work?
 		if (L::Nowhere == eNewHeading) {
 
 			// try again with 2nd and 3rd cells
-			if (3 <= this->apCells.length()) {
+			if (3 <= this->oBody.length()) {
 
-				eNewHeading = L::oppositeHeading(this->apCells.at(1)->getPos(),
-												 this->apCells.at(2)->getPos());
+				eNewHeading = L::oppositeHeading(this->bodyPoint(1),
+												 this->bodyPoint(2));
 
 				if (L::Nowhere == eNewHeading) bSolveWithHeadOnly = true;
 
@@ -396,32 +381,6 @@ void Worm::onSetLives(const quint8 ubLives) {
 } // onSetLives
 
 
-// old way
-void Worm::onSetSpawnCell(SurfaceCell *pCell) {
-
-	this->onDebugMessage("OLD !!!!!!!!! onSetSpawnCell  ");
-	return ;
-
-	this->pCellSpawn = pCell;
-	this->oPointSpawn = pCell->getPos();
-
-	// determine initial heading from spawn-cell
-	switch (this->pCellSpawn->getState()) {
-		case L::SpawnHeadingNorth: this->eCurrentHeading = L::North; break;
-		case L::SpawnHeadingWest: this->eCurrentHeading = L::West; break;
-		case L::SpawnHeadingSouth: this->eCurrentHeading = L::South; break;
-		case L::SpawnHeadingEast:
-		default:
-			this->eCurrentHeading = L::East;
-		break;
-
-	} // switch pCell->getState()
-
-	this->eSpawnHeading = this->eCurrentHeading;
-
-} // onSetSpawnCell
-
-
 void Worm::onSetSpawnPoint(const QPoint oPoint, const quint8 ubState) {
 
 	this->oPointSpawn = oPoint;
@@ -482,29 +441,93 @@ void Worm::onTurnRight() {
 } // onTurnRight
 
 
-QPoint Worm::rightPoint() {
+void Worm::readState(QDataStream &oStream) {
+
+	quint8 ubHeading;
+	quint8 ubHeadingSpawn;
+	quint8 ubX;
+	quint8 ubY;
+	quint16 uiCount;
+
+	oStream >> this->uiCountLevels >> this->uiTargetLength
+			>> this->ubLives >> this->ubLivesLost >> this->ubLivesMax
+			>> this->ubSpawnSafetyTicks >> this->ulScore
+			>> ubHeading >> ubHeadingSpawn >> ubX >> ubY >> uiCount;
+
+	this->eCurrentHeading = L::Heading(ubHeading);
+	this->eSpawnHeading = L::Heading(ubHeadingSpawn);
+	this->oPointSpawn = QPoint(ubX, ubY);
+
+	// map already has the tiles, see MapGame::readState()
+	this->oBody.clear();
+	this->aeNextHeadings.clear();
+	for (quint16 ui = 0u; ui < uiCount; ++ui) {
+
+		oStream >> ubX >> ubY;
+
+		if (!this->pMap->contains(ubX, ubY)) {
+
+			this->oBody.clear();
+			oStream.setStatus(QDataStream::ReadCorruptData);
 
-	if (0 == this->apCells.length()) return QPoint();
+			return;
 
-	SurfaceCell *pCell = this->apCells.first();
+		} // if off the map
 
-	return L::warpPoint(pCell->getPos(), this->headingRight());
+		this->oBody.append(quint16(this->pMap->cellIndex(ubX, ubY)));
+
+	} // loop cells
+
+	Q_EMIT this->updateLives(this->ubLives);
+	Q_EMIT this->updateScore(this->ulScore);
+
+} // readState
+
+
+QPoint Worm::rightPoint() {
+
+	if (0 == this->oBody.length()) return QPoint();
+
+	return this->pMap->neighbourPoint(this->bodyPoint(0), this->headingRight());
 
 } // rightPoint
 
 
+void Worm::removeFromMap() {
+
+	quint8 ubStateMin = this->headState();
+	quint8 ubStateMax = this->tailState();
+	quint8 ubState;
+	QPoint oPoint;
+
+	while (this->oBody.length()) {
+
+		oPoint = this->pMap->cellPoint(this->oBody.takeLast());
+		ubState = this->pMap->tile(oPoint);
+
+		// leave cells that others have taken over
+		if ((ubStateMin > ubState) || (ubStateMax < ubState)) continue;
+
+		this->pMap->defrostTile(oPoint);
+
+	} // loop
+
+} // removeFromMap
+
+
 void Worm::setColourIndex(const quint8 ubIndex) {
 
 	this->ubColourIndex = ubIndex;
 
-	this->headCell()->setState(this->headState());
-	this->tailCell()->setState(this->tailState());
+	this->pMap->setTile(this->headPoint(), this->headState());
+	this->pMap->setTile(this->tailPoint(), this->tailState());
 
 	quint8 ubState = this->midState();
+	const QVector<quint16> auiCells = this->oBody.toVector();
 
-	for (int i = 1; i < this->apCells.length() -1; ++i) {
+	for (int i = 1; i < auiCells.length() -1; ++i) {
 
-		this->apCells.at(i)->setState(ubState);
+		this->pMap->setTile(this->pMap->cellPoint(auiCells.at(i)), ubState);
 
 	} // loop
 
@@ -513,26 +536,59 @@ void Worm::setColourIndex(const quint8 ubIndex) {
 } // setColourIndex
 
 
+void Worm::setMap(MapGame *pMap) {
+
+	this->pMap = pMap;
+
+	if (pMap) this->oBody.setNeighbours(Map::neighbourTable(pMap->columns(),
+															 pMap->rows()));
+	else this->oBody.clear();
+
+} // setMap
+
+
 void Worm::startSpawning() {
 
-	this->apCells.clear();
+	this->oBody.clear();
 
 	this->uiTargetLength = 5u;
 	this->ubSpawnSafetyTicks = 7u;
 
 	this->aeNextHeadings.clear();
 	this->eCurrentHeading = this->eSpawnHeading;
-	this->eNextBloat = L::Nowhere;
 
 } // startSpawning
 
 
-SurfaceCell *Worm::tailCell() {
+QPoint Worm::tailPoint() const {
+
+	return this->uiTargetLength <= this->oBody.length()
+			? this->bodyPoint(this->oBody.length() - 1)
+			: QPoint(0xFFu, 0xFFu);
+
+} // tailPoint
+
+
+void Worm::writeState(QDataStream &oStream) const {
+
+	const QVector<quint16> auiCells = this->oBody.toVector();
+	QPoint oPoint;
+
+	oStream << this->uiCountLevels << this->uiTargetLength
+			<< this->ubLives << this->ubLivesLost << this->ubLivesMax
+			<< this->ubSpawnSafetyTicks << this->ulScore
+			<< quint8(this->eCurrentHeading) << quint8(this->eSpawnHeading)
+			<< quint8(this->oPointSpawn.x()) << quint8(this->oPointSpawn.y())
+			<< quint16(this->oBody.length());
+
+	for (int i = 0; i < auiCells.length(); ++i) {
+
+		oPoint = this->pMap->cellPoint(auiCells.at(i));
+		oStream << quint8(oPoint.x()) << quint8(oPoint.y());
 
-	return this->uiTargetLength <= this->apCells.length() ? this->apCells.last()
-														  : new SurfaceCell();
+	} // loop cells
 
-} // tailCell
+} // writeState
 
 
 
@@ -18,9 +18,13 @@
 #ifndef WORM_H
 #define WORM_H
 
+#include <QDataStream>
 #include <QObject>
-#include "SurfaceCell.h"
+#include <QPoint>
+#include <QVector>
 #include "Lingo.h"
+#include "MapGame.h"
+#include "WormBody.h"
 
 
 
@@ -47,13 +51,16 @@ protected:
 	quint8 ubSpawnSafetyTicks;
 	quint32 ulScore;
 	QPoint oPointSpawn;
-	SurfaceCell *pCellSpawn;
+	MapGame *pMap;
 	QString sName;
-	QVector<SurfaceCell *> apCells;
+	// cells of pMap occupied, head first
+	WormBody oBody;
 	QVector<L::Heading> aeNextHeadings;
 	L::Heading eCurrentHeading;
 	L::Heading eSpawnHeading;
-	L::Heading eNextBloat;
+
+	inline QPoint bodyPoint(const int iIndex) const {
+		return this->pMap->cellPoint(this->oBody.at(iIndex)); }
 
 	void doNextTurn();
 
@@ -61,13 +68,13 @@ public:
 
 	explicit Worm(const QPoint oPoint, const quint8 ubState,
 				  const quint8 ubColour, const bool bAI, const quint8 ubLivesMax,
-				  QObject *pParent = nullptr);
+				  MapGame *pMap, QObject *pParent = nullptr);
 	virtual ~Worm();
 
 	virtual void addLength(int iLength);
-	virtual void advanceTo(SurfaceCell *pCell);
+	virtual void advanceTo(const QPoint oPoint);
 	// cell that will become tail next (2nd-last)
-	virtual SurfaceCell *assCell();
+	virtual QPoint assPoint() const;
 	// these may not be used as we may be using 8 of 10 states for heads and tails
 	QT_DEPRECATED inline virtual quint8 bloatedNstate() { return (this->ubColourIndex * 10u) + 13u; }
 	QT_DEPRECATED inline virtual quint8 bloatedEstate() { return (this->ubColourIndex * 10u) + 14u; }
@@ -76,34 +83,43 @@ public:
 	inline virtual quint8 colourIndex() const { return this->ubColourIndex; }
 	inline virtual L::Heading currentDirection() const { return this->eCurrentHeading; }
 	// cell that leads the worm (1st)
-	virtual SurfaceCell *headCell();
+	virtual QPoint headPoint() const;
 	virtual L::Heading headingLeft() const;
 	virtual L::Heading headingRight() const;
 	inline virtual quint8 headState() { return (this->ubColourIndex * 10u) + 10u; }
 	inline virtual bool isAI() { return this->bAmAI; }
 	inline virtual bool isDead() { return 0u == this->ubLives; }
 	inline virtual bool isImmune() { return 0u < this->ubSpawnSafetyTicks; }
+	inline virtual int length() const { return this->oBody.length(); }
 	inline virtual quint8 midState() { return (this->ubColourIndex * 10u) + 14u; }
 	// cell that comes after the head (2nd)
-	virtual SurfaceCell *neckCell();
+	virtual QPoint neckPoint() const;
 	virtual QPoint leftPoint();
 	inline virtual quint16 levelCount() const { return this->uiCountLevels; }
 	inline virtual quint8 livesLost() const { return this->ubLivesLost; }
 	inline virtual QString name() const { return this->sName; }
 	virtual QPoint nextPoint();
+	// counterpart of writeState(), colour, name and controls are kept.
+	// Sets oStream to ReadCorruptData if a cell is off the map
+	virtual void readState(QDataStream &oStream);
 	virtual QPoint rightPoint();
+	// clear own cells from map and forget them
+	virtual void removeFromMap();
 	inline virtual quint32 score() const { return this->ulScore; }
 	virtual void setColourIndex(const quint8 ubIndex);
 	inline virtual void setHeading(const L::Heading eDirection) { this->eCurrentHeading = eDirection; }
-	inline virtual void setNextBloatHeading(const L::Heading eDirection) { this->eNextBloat = eDirection; }
+	// a new map invalidates any cells we had
+	virtual void setMap(MapGame *pMap);
 	inline virtual void setUseRelativeControls(bool bUse) { this->bUseRelativeControls = bUse; }
 	inline virtual QPoint spawnPoint() const { return this->oPointSpawn; }
 	virtual void startSpawning();
 	// cell that comes last
-	virtual SurfaceCell *tailCell();
+	virtual QPoint tailPoint() const;
 	inline virtual quint8 tailState() { return (this->ubColourIndex * 10u) + 19u; }
 	inline virtual quint16 targetLength() { return this->uiTargetLength; }
 	inline virtual bool usesRelativeControls() const { return this->bUseRelativeControls; }
+	// everything that changes during play except queued key presses
+	virtual void writeState(QDataStream &oStream) const;
 
 signals:
 	void debugMessage(const QString &sMessage) const;
@@ -126,7 +142,6 @@ public slots:
 	void onReverse();
 	void onSetLives(const quint8 ubLives);
 	inline void onSetName(const QString sName) { this->sName = sName; Q_EMIT this->updateName(sName); }
-	QT_DEPRECATED void onSetSpawnCell(SurfaceCell *pCell);
 	void onSetSpawnPoint(const QPoint oPoint, const quint8 ubState);
 	void onSubtractLife();
 	// key press entrance
@@ -16,10 +16,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "WormAI.h"
+#include "Trace.h"
 
-#include "IconEngine.h"
-
-#include <QTime>
 
 
 
@@ -27,17 +25,25 @@ namespace SwissalpS { namespace QtNibblers {
 
 
 
-WormAI::WormAI(QObject *pParent) :
+WormAI::WormAI(Random *pRandom, QObject *pParent) :
 	QObject(pParent),
-	ubCountDeadendRun(1u),
+	eEffort(EffortFull),
+	iHeadSelf(-1),
 	pMapGame(nullptr),
-	pMapShaddow(nullptr) {
+	pMapToPlan(nullptr),
+	pRandom(pRandom),
+	pWormPlanned(nullptr),
+	pWormToPlan(nullptr) {
+
+	// Game starts the same one every tick
+	this->setAutoDelete(false);
 
-	this->pMapShaddow = new Map(SssS_Nibblers_Surface_Width,
-								SssS_Nibblers_Surface_Height, this);
+	for (int i = 0; i < 4; ++i) {
 
-	// init randomizer
-	qsrand(uint(QTime::currentTime().msecsSinceStartOfDay()));
+		this->abCanMove[i] = this->abWander[i] = false;
+		this->ailScores[i] = 0;
+
+	} // loop headings
 
 } // construct
 
@@ -48,18 +54,15 @@ WormAI::~WormAI() {
 
 
 // virtual copy of worm.vala Worm.can_move_to(....)
-bool WormAI::canMoveTo(Worm *pWorm) {
+bool WormAI::canMoveTo(Worm *pWorm, const L::Heading eDirection) {
 
 	if (pWorm->isImmune()) return true;
 
-	quint8 ubState = this->pMapGame->tile(pWorm->nextPoint());
+	quint8 ubState = this->pMapGame->tile(
+						 this->pMapGame->neighbourPoint(pWorm->headPoint(), eDirection));
 	if (L::NullTile == ubState) return false;
 
-	static QVector<quint8> aStatesToAvoid;
-	if (aStatesToAvoid.isEmpty())
-		aStatesToAvoid = IconEngine::statesSnakes() + IconEngine::statesWalls();
-
-	return !aStatesToAvoid.contains(ubState);
+	return !L::isTile(ubState, L::ClassSolid);
 
 } // canMoveTo
 
@@ -77,33 +80,19 @@ bool WormAI::canMoveTo(Worm *pWorm) {
  * appear empty). Although in theory deadend_runnumber may wrap round,
  * after 4 billion steps the entire board is likely to have been
  * overwritten anyway.
+ * Here the board is a Bitboard of free cells that deadendAfter() starts
+ * fresh for every run, and the dead end is filled 64 cells at a time.
+ * Every run counts the same cells in any order, so the result is the
+ * same as the original's.
  */
-qint32 WormAI::deadend(const QPoint oStart, qint32 ilLen) {
-
-	static QVector<quint8> aStatesToAvoid;
-	if (aStatesToAvoid.isEmpty())
-		aStatesToAvoid = IconEngine::statesSnakes() + IconEngine::statesWalls();
+qint32 WormAI::deadend(const int iStart, qint32 ilLen) {
 
 	if (0 >= ilLen) return 0;
 
-	QPoint oNext;
-
-	for (quint8 ubDirection = L::North; ubDirection <= L::East; ubDirection++) {
+	const int iCount = this->oDeadendReached.flood(this->oDeadendPassable,
+												   iStart, ilLen);
 
-		oNext = L::warpPoint(oStart, ubDirection);
-
-		if ((!aStatesToAvoid.contains(this->pMapGame->tile(oNext)))
-				&& (this->ubCountDeadendRun != this->pMapShaddow->tile(oNext))) {
-
-			this->pMapShaddow->setTile(oNext, this->ubCountDeadendRun);
-			ilLen = this->deadend(oNext, ilLen - 1);
-			if (0 >= ilLen) return 0;
-
-		} // if free cell
-
-	} // loop all directions
-
-	return ilLen;
+	return (iCount >= ilLen) ? 0 : ilLen - iCount;
 
 } // deadend
 
@@ -118,28 +107,32 @@ qint32 WormAI::deadend(const QPoint oStart, qint32 ilLen) {
  * least BOARDWIDTH, so that on the levels with long thin paths a worm
  * won't start down the path if it'll crash at the other end.
  */
-qint32 WormAI::deadendAfter(Worm *pWorm, const QVector<Worm *> apWorms, const qint32 ilLen) {
+qint32 WormAI::deadendAfter(Worm *pWorm, const QVector<Worm *> apWorms,
+							 const L::Heading eDirection, const qint32 ilLen) {
 
-	if (L::NullTile == this->pMapGame->tile(pWorm->nextPoint())) return 0;
+	QPoint oNext = this->pMapGame->neighbourPoint(pWorm->headPoint(), eDirection);
+	if (L::NullTile == this->pMapGame->tile(oNext)) return 0;
 
-	if (255u == this->ubCountDeadendRun) {
+	const QPoint oStart = this->pMapGame->neighbourPoint(oNext, eDirection);
+	qint32 ilCl = (ilLen * ilLen) / 16;
+	if (SssS_Nibblers_Surface_Width > ilCl) ilCl = SssS_Nibblers_Surface_Width;
 
-		// this should never happen the way I've set it up to clear
-		// counter on each call to move (a bit much, only goes up to 23 with 8 worms)
-		this->onDebugMessage("ran out of space in deadendnumber SurfaceGame::aiDeadendAfter");
+	// usually the regions Game labelled already know the answer
+	const int iRoom = this->pMapGame->regionRoom(this->aiHeads, this->iHeadSelf,
+												 this->pMapGame->cellIndex(oNext),
+												 this->pMapGame->cellIndex(oStart));
+	if (0 <= iRoom) return (iRoom >= ilCl) ? 0 : ilCl - iRoom;
 
-		return 0;
+	// flooding is what Game saves on first when short of time
+	if (EffortRegionsOnly <= this->eEffort) return 0;
 
-	} // if ran out of space
-	this->ubCountDeadendRun++;
+	// free cells of the board as they are now
+	this->oDeadendPassable.assign(this->pMapGame->freeCells());
 
-	qint32 ilCl;
-	QPoint oNext = pWorm->nextPoint();
 	quint8 ubX = quint8(oNext.x());
 	quint8 ubY = quint8(oNext.y());
 
 	QPoint oHeadOther;
-	L::Heading eDirection = pWorm->currentDirection();
 
 	Worm *pWormOther;
 	for (int i = 0; i < apWorms.length(); ++i) {
@@ -148,56 +141,96 @@ qint32 WormAI::deadendAfter(Worm *pWorm, const QVector<Worm *> apWorms, const qi
 		if (pWormOther == pWorm) continue;
 		if (pWormOther->isDead()) continue;
 
-		oHeadOther = pWormOther->headCell()->getPos();
+		oHeadOther = pWormOther->headPoint();
 
 		if (oHeadOther.x() != ubX || oHeadOther.y() != ubY) {
 
-			this->pMapShaddow->setTile(L::warpPoint(oHeadOther, L::North), this->ubCountDeadendRun);
-			this->pMapShaddow->setTile(L::warpPoint(oHeadOther, L::West), this->ubCountDeadendRun);
-			this->pMapShaddow->setTile(L::warpPoint(oHeadOther, L::South), this->ubCountDeadendRun);
-			this->pMapShaddow->setTile(L::warpPoint(oHeadOther, L::East), this->ubCountDeadendRun);
+			this->markDeadend(this->pMapGame->neighbourPoint(oHeadOther, L::North));
+			this->markDeadend(this->pMapGame->neighbourPoint(oHeadOther, L::West));
+			this->markDeadend(this->pMapGame->neighbourPoint(oHeadOther, L::South));
+			this->markDeadend(this->pMapGame->neighbourPoint(oHeadOther, L::East));
 
 		} // if
 
 	} // loop worms
 
-	this->pMapShaddow->setTile(oNext, this->ubCountDeadendRun);
+	this->markDeadend(oNext);
+	this->markDeadend(oStart);
 
-	oNext = L::warpPoint(oNext, eDirection);
+	return this->deadend(this->pMapGame->cellIndex(oStart), ilCl);
 
-	this->pMapShaddow->setTile(oNext, this->ubCountDeadendRun);
+} // deadendAfter
 
-	ilCl = (ilLen * ilLen) / 16;
-	if (SssS_Nibblers_Surface_Width > ilCl) ilCl = SssS_Nibblers_Surface_Width;
 
-	return this->deadend(oNext, ilCl);
+bool WormAI::hasSolidNear(const QPoint oPoint) const {
 
-} // deadendAfter
+	const int iColumns = this->pMapGame->columns();
+	const int iRows = this->pMapGame->rows();
+	const int iNear = SssS_Nibblers_AI_Near;
+	int iX, iY;
 
+	for (int iDY = -iNear; iDY <= iNear; ++iDY) {
 
-// virtual copy of worm.vala Worm.ai_move(....)
-void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMap) {
+		iY = (oPoint.y() + iDY + iRows) % iRows;
 
-	this->pMapGame = pMap;
-	if (nullptr == this->pMapGame) {
+		for (int iDX = -iNear; iDX <= iNear; ++iDX) {
 
-		this->onDebugMessage("No MapGame defined.");
-		return;
+			iX = (oPoint.x() + iDX + iColumns) % iColumns;
 
-	} // if have no map
+			if (L::isTile(this->pMapGame->tile(quint8(iX), quint8(iY)), L::ClassSolid))
+				return true;
 
-	// check how messy shaddow map has become
-	if (222u <= this->ubCountDeadendRun) {
+		} // loop columns
+
+	} // loop rows
+
+	return false;
 
-		this->pMapShaddow->fillAll(L::FloorClean);
-		this->ubCountDeadendRun = 1u;
+} // hasSolidNear
 
-	} // if time to clean up shadow-map aka Worm::deadend_board
+
+QVector<int> WormAI::headCells(const QVector<Worm *> apWorms, const MapGame *pMap,
+							   const Worm *pWorm, int *piIndex) {
+
+	QVector<int> aiCells;
+	QPoint oHead;
+	Worm *pWormOther;
+	for (int i = 0; i < apWorms.length(); ++i) {
+
+		pWormOther = apWorms.at(i);
+		if (pWormOther->isDead()) continue;
+
+		if ((pWormOther == pWorm) && (nullptr != piIndex)) *piIndex = aiCells.length();
+
+		oHead = pWormOther->headPoint();
+		if (pMap->contains(quint8(oHead.x()), quint8(oHead.y())))
+			aiCells.append(pMap->cellIndex(oHead));
+		else aiCells.append(-1);
+
+	} // loop worms
+
+	return aiCells;
+
+} // headCells
+
+
+// virtual copy of worm.vala Worm.ai_move(....)
+// applies what plan() found, draws random numbers just like the original
+void WormAI::move(Worm *pWorm) {
+
+	if (pWorm != this->pWormPlanned) {
+
+		this->onDebugMessage("move() without plan()");
+		return;
+
+	} // if nothing planned for this worm
+
+	this->pWormPlanned = nullptr;
 
 	// check immediate surrounding
-	bool bAhead = this->wander(pWorm->nextPoint(), pWorm->nextPoint(), pWorm->currentDirection());
-	bool bLeft = this->wander(pWorm->leftPoint(), pWorm->leftPoint(), pWorm->headingLeft());
-	bool bRight = this->wander(pWorm->rightPoint(), pWorm->rightPoint(), pWorm->headingRight());
+	bool bAhead = this->abWander[WormAI::headingIndex(pWorm->currentDirection())];
+	bool bLeft = this->abWander[WormAI::headingIndex(pWorm->headingLeft())];
+	bool bRight = this->abWander[WormAI::headingIndex(pWorm->headingRight())];
 
 	if (!bAhead) {
 
@@ -206,9 +239,9 @@ void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMa
 		else {
 
 			// move randomly
-			if ((qrand() % 31) == 1) {
+			if (1u == this->pRandom->bounded(31u)) {
 
-				if (qrand() & 1) pWorm->onTurnLeft();
+				if (this->pRandom->next() & 1u) pWorm->onTurnLeft();
 				else pWorm->onTurnRight();
 
 			} // if random turn
@@ -236,8 +269,6 @@ void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMa
 
 	for (quint8 ubDirection = 0; ubDirection < 3; ++ubDirection) {
 
-		ilLen = 0;
-
 		if (0u == ubDirection) {
 			// ahead
 
@@ -252,11 +283,8 @@ void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMa
 
 		} // switch direction
 
-		if (!this->canMoveTo(pWorm)) ilLen += uiCapacity;
-
-		if (this->tooClose(pWorm, apWorms)) ilLen += 4;
-
-		ilLen += this->deadendAfter(pWorm, apWorms, ilLen);
+		// walls, heads and dead-ends, see plan()
+		ilLen = this->ailScores[WormAI::headingIndex(pWorm->currentDirection())];
 
 		// favour current direction
 		if ((pWorm->currentDirection() == eDirectionOld) && (0 >= ilLen))
@@ -269,7 +297,7 @@ void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMa
 		 */
 		if (0 >= ilLen) {
 
-			ilLen -= (qrand() % 101);
+			ilLen -= qint32(this->pRandom->bounded(101u));
 
 		} // if introduce noise
 
@@ -288,11 +316,11 @@ void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMa
 	/* Make sure we are at least avoiding walls.
 	 * Mostly other snakes should avoid our head.
 	 */
-	if (!this->canMoveTo(pWorm)) {
+	if (!this->abCanMove[WormAI::headingIndex(pWorm->currentDirection())]) {
 
 		pWorm->onTurnLeft();
 
-		if (!this->canMoveTo(pWorm)) {
+		if (!this->abCanMove[WormAI::headingIndex(pWorm->currentDirection())]) {
 
 			// try right
 			pWorm->onTurnRight();
@@ -305,19 +333,101 @@ void WormAI::move(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMa
 } // move
 
 
+// scores every heading move() may look at without changing pWorm or pMap
+void WormAI::plan(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMap) {
+
+	SssS_Nibblers_Trace_Detail_Span(PhaseAIPlan, quint32(apWorms.indexOf(pWorm)));
+
+	this->pMapGame = pMap;
+	this->pWormPlanned = nullptr;
+	if (nullptr == this->pMapGame) {
+
+		this->onDebugMessage("No MapGame defined.");
+		return;
+
+	} // if have no map
+
+	this->iHeadSelf = -1;
+	this->aiHeads = WormAI::headCells(apWorms, pMap, pWorm, &this->iHeadSelf);
+
+	static const quint16 uiCapacity = SssS_Nibblers_Surface_Height * SssS_Nibblers_Surface_Width;
+	const QPoint oHead = pWorm->headPoint();
+	const int iBack = WormAI::headingIndex(pWorm->currentDirection()) ^ 2;
+	L::Heading eDirection;
+	QPoint oNext;
+	qint32 ilLen;
+	int i;
+
+	for (i = 0; i < 4; ++i) {
+
+		eDirection = L::Heading(L::North + i);
+		oNext = this->pMapGame->neighbourPoint(oHead, eDirection);
+
+		this->abCanMove[i] = this->canMoveTo(pWorm, eDirection);
+		this->abWander[i] = this->wander(oNext, oNext, eDirection);
+
+	} // loop headings
+
+	// going back is only looked at once move() turned away from ahead
+	const bool bNeedBack = !this->abWander[WormAI::headingIndex(pWorm->currentDirection())];
+
+	// cheaper plans when Game runs late, see setEffort()
+	const bool bDeadend = (EffortReflex > this->eEffort)
+						  && ((EffortNearOnly > this->eEffort) || this->hasSolidNear(oHead));
+
+	for (i = 0; i < 4; ++i) {
+
+		eDirection = L::Heading(L::North + i);
+		this->ailScores[i] = 0;
+
+		if ((iBack == i) && !bNeedBack) continue;
+
+		ilLen = 0;
+
+		if (!this->abCanMove[i]) ilLen += uiCapacity;
+
+		if (this->tooClose(pWorm, apWorms, eDirection)) ilLen += 4;
+
+		if (bDeadend) ilLen += this->deadendAfter(pWorm, apWorms, eDirection, ilLen);
+
+		this->ailScores[i] = ilLen;
+
+	} // loop headings
+
+	this->pWormPlanned = pWorm;
+
+} // plan
+
+
+void WormAI::run() {
+
+	this->plan(this->pWormToPlan, this->apWormsToPlan, this->pMapToPlan);
+
+} // run
+
+
+void WormAI::setPlan(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMap) {
+
+	this->pWormToPlan = pWorm;
+	this->apWormsToPlan = apWorms;
+	this->pMapToPlan = pMap;
+
+} // setPlan
+
+
 // virtual copy of worm.vala Worm.ai_too_close(....)
 /* Check to see if another worm's head is too close in front of us;
  * that is, that it's within 3 in the direction we're going and within
  * 1 to the side.
  */
-bool WormAI::tooClose(Worm *pWorm, const QVector<Worm *> apWorms) {
+bool WormAI::tooClose(Worm *pWorm, const QVector<Worm *> apWorms,
+					  const L::Heading eDirection) {
 
 	if (pWorm->isImmune()) return false;
 
 	int iDx, iDy;
-	QPoint oHead = pWorm->headCell()->getPos();
+	QPoint oHead = pWorm->headPoint();
 	QPoint oHeadOther;
-	L::Heading eDirection = pWorm->currentDirection();
 
 	Worm *pWormOther;
 	for (int i = 0; i < apWorms.length(); ++i) {
@@ -326,9 +436,7 @@ bool WormAI::tooClose(Worm *pWorm, const QVector<Worm *> apWorms) {
 		if (pWormOther == pWorm) continue;
 		if (pWormOther->isDead()) continue;
 
-this->onDebugMessage("checking worm");
-
-		oHeadOther = pWormOther->headCell()->getPos();
+		oHeadOther = pWormOther->headPoint();
 
 		iDx = oHead.x() - oHeadOther.x();
 		iDy = oHead.y() - oHeadOther.y();
@@ -369,60 +477,38 @@ this->onDebugMessage("checking worm");
 bool WormAI::wander(const QPoint oStart, const QPoint oStop,
 					const L::Heading eDirection) {
 
-	if (oStart.isNull() || oStart.x() >= 0xFF || oStart.y() >= 0xFF) return false;
-	if (oStop.isNull() || oStop.x() >= 0xFF || oStop.y() >= 0xFF) return false;
-	if (L::Nowhere == eDirection) return false;
-
-	static QVector<quint8> aStatesToAvoid;
-	if (aStatesToAvoid.isEmpty())
-		aStatesToAvoid = IconEngine::statesSnakes() + IconEngine::statesWalls();
-
-	QPoint oNext = L::warpPoint(oStart, eDirection);
-	if (oNext.isNull() || oNext.x() >= 0xFF || oNext.y() >= 0xFF) return false;
-
-	quint8 ubState = this->pMapGame->tile(oStart);
-	if (L::NullTile == ubState) return false;
-	if (aStatesToAvoid.contains(ubState)) return false;
+	if (oStart.isNull() || !this->pMapGame->contains(quint8(oStart.x()), quint8(oStart.y())))
+		return false;
 
-	switch (ubState) {
+	if (oStop.isNull() || !this->pMapGame->contains(quint8(oStop.x()), quint8(oStop.y())))
+		return false;
 
-		case L::BonusAppleNW:
-		case L::BonusAppleNE:
-		case L::BonusAppleSE:
-		case L::BonusAppleSW:
-			return true;
+	if ((L::North > eDirection) || (L::East < eDirection)) return false;
 
-		case L::BonusCherryNW:
-		case L::BonusCherryNE:
-		case L::BonusCherrySE:
-		case L::BonusCherrySW:
-			return false;
+	const int iStop = this->pMapGame->cellIndex(oStop);
+	int iCell = this->pMapGame->cellIndex(oStart);
+	int iNext;
+	MapGame::Wander eWander;
 
-		case L::BonusBananaNW:
-		case L::BonusBananaNE:
-		case L::BonusBananaSE:
-		case L::BonusBananaSW:
-			return true;
+	// a lap around the line is what refreshLines() keeps ready
+	if ((iCell == iStop) && this->pMapGame->isLineFresh(iCell, eDirection))
+		return this->pMapGame->bonusAhead(iCell, eDirection);
 
-		case L::BonusHeartNW:
-		case L::BonusHeartNE:
-		case L::BonusHeartSE:
-		case L::BonusHeartSW:
-			return true;
+	// walk in a straight line instead of recursing cell by cell
+	while (true) {
 
-		case L::BonusDiamondNW:
-		case L::BonusDiamondNE:
-		case L::BonusDiamondSE:
-		case L::BonusDiamondSW:
-			return true;
+		// cell 0 is QPoint(), which never counted as a place to go
+		iNext = this->pMapGame->neighbour(iCell, eDirection);
+		if (0 == iNext) return false;
 
-		default:
+		eWander = MapGame::wanderTile(this->pMapGame->tileAt(iCell));
+		if (MapGame::WanderOn != eWander) return (MapGame::WanderFound == eWander);
 
-			if (oNext == oStop) return false;
+		if (iNext == iStop) return false;
 
-			return this->wander(oNext, oStop, eDirection);
+		iCell = iNext;
 
-	} // switch state
+	} // loop until something is found
 
 } // wander
 
@@ -22,10 +22,14 @@
 #ifndef WORMAI_H
 #define WORMAI_H
 
+#include <QElapsedTimer>
 #include <QObject>
+#include <QRunnable>
+#include "Bitboard.h"
 #include "Lingo.h"
 #include "Map.h"
 #include "MapGame.h"
+#include "Random.h"
 #include "Worm.h"
 
 
@@ -34,30 +38,100 @@ namespace SwissalpS { namespace QtNibblers {
 
 
 
-class WormAI : public QObject {
+// Decides where AI worms go in two steps: plan() only reads worms and map
+// so several WormAI can plan at once, one per worm, e.g. from a thread
+// pool via setPlan() and run(). move() then applies the plan and draws
+// random numbers, so it has to be called in worm order.
+class WormAI : public QObject, public QRunnable {
 
 	Q_OBJECT
 
+public:
+	// how much plan() may cost, Game lowers it when ticks run late
+	enum Effort {
+		// all GNOME-Nibbles looks at
+		EffortFull = 0u,
+		// no dead-end check for worms with nothing solid near their head
+		EffortNearOnly = 1u,
+		// also dead ends only from labelled regions, never flooding
+		EffortRegionsOnly = 2u,
+		// walls and heads only
+		EffortReflex = 3u
+	};
+	Q_ENUM(Effort)
+
 private:
 
 protected:
-	quint8 ubCountDeadendRun;
+	// aka Worm::deadend_board: free cells of pMapGame minus the ones
+	// deadendAfter() blocks off
+	Bitboard oDeadendPassable;
+	// cells deadend() reached
+	Bitboard oDeadendReached;
+	// per heading, index see headingIndex(), filled by plan()
+	bool abCanMove[4];
+	bool abWander[4];
+	qint32 ailScores[4];
+	Effort eEffort;
+	// heads of living worms as cells, see headCells(), and which one is
+	// the worm being planned for
+	QVector<int> aiHeads;
+	int iHeadSelf;
 
 	const MapGame *pMapGame;
-	Map *pMapShaddow;
-
-	virtual bool canMoveTo(Worm *pWorm);
-	virtual qint32 deadend(const QPoint oStart, qint32 ilLen);
-	virtual qint32 deadendAfter(Worm *pWorm, const QVector<Worm *>apWorms, const qint32 ilLen);
-	virtual bool tooClose(Worm *pWorm, const QVector<Worm *>apWorms);
+	const MapGame *pMapToPlan;
+	// owned by Game
+	Random *pRandom;
+	// worm plan() was last called for, nullptr once move() used it
+	Worm *pWormPlanned;
+	// set by setPlan() for run()
+	Worm *pWormToPlan;
+	QVector<Worm *> apWormsToPlan;
+
+	virtual bool canMoveTo(Worm *pWorm, const L::Heading eDirection);
+	virtual qint32 deadend(const int iStart, qint32 ilLen);
+	virtual qint32 deadendAfter(Worm *pWorm, const QVector<Worm *>apWorms,
+								const L::Heading eDirection, const qint32 ilLen);
+
+	// anything solid within SssS_Nibblers_AI_Near cells of oPoint
+	virtual bool hasSolidNear(const QPoint oPoint) const;
+	inline static int headingIndex(const L::Heading eDirection) {
+		return (eDirection - L::North) & 3; }
+
+	inline void markDeadend(const QPoint oPoint) {
+		if (this->pMapGame->contains(quint8(oPoint.x()), quint8(oPoint.y())))
+			this->oDeadendPassable.setAt(this->pMapGame->cellIndex(oPoint), false); }
+
+	virtual bool tooClose(Worm *pWorm, const QVector<Worm *>apWorms,
+						  const L::Heading eDirection);
 	virtual bool wander(const QPoint oStart, const QPoint oStop,
 								 const L::Heading eDirection);
 
 public:
-	explicit WormAI(QObject *pParent = nullptr);
+	explicit WormAI(Random *pRandom, QObject *pParent = nullptr);
 	virtual ~WormAI();
 
-	virtual void move(Worm *pWorm, const QVector<Worm *>apWorms, const MapGame *pMap);
+	inline virtual Effort effort() const { return this->eEffort; }
+	// cell index of every living worm's head in worm order, -1 for heads
+	// off the map. If pWorm is given, piIndex receives its position.
+	static QVector<int> headCells(const QVector<Worm *>apWorms, const MapGame *pMap,
+								  const Worm *pWorm = nullptr, int *piIndex = nullptr);
+	// false while decisions follow from the random state alone, else Game
+	// records the headings this AI picks in replays
+	inline virtual bool isRecorded() const { return false; }
+	// turns pWorm as planned, see plan()
+	virtual void move(Worm *pWorm);
+	// scores the ways pWorm may go, reads but never changes worms or pMap
+	virtual void plan(Worm *pWorm, const QVector<Worm *>apWorms, const MapGame *pMap);
+	// plans for worm given to setPlan()
+	virtual void run() override;
+	// plans that take their time stop once pClock passed illDeadline
+	// nanoseconds. nullptr for no limit.
+	inline virtual void setDeadline(const QElapsedTimer *pClock, const qint64 illDeadline) {
+		Q_UNUSED(pClock) Q_UNUSED(illDeadline) }
+
+	virtual void setPlan(Worm *pWorm, const QVector<Worm *>apWorms, const MapGame *pMap);
+	inline virtual void setEffort(const Effort eEffort) { this->eEffort = eEffort; }
 	inline virtual void setMap(MapGame *pMapGame) { this->pMapGame = pMapGame; }
 
 signals:
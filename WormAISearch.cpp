@@ -0,0 +1,282 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WormAISearch.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+WormAISearch::WormAISearch(Random *pRandom, QObject *pParent) :
+	WormAI(pRandom, pParent),
+	bOutOfTime(false),
+	iDepthDone(0),
+	ilNeed(0),
+	illDeadline(0),
+	ulNodes(0u),
+	oSearchFree(SssS_Nibblers_Surface_Width, SssS_Nibblers_Surface_Height),
+	oSearchPassable(SssS_Nibblers_Surface_Width, SssS_Nibblers_Surface_Height),
+	oSearchReached(SssS_Nibblers_Surface_Width, SssS_Nibblers_Surface_Height),
+	pClock(nullptr) {
+
+	for (int i = 0; i < 4; ++i) this->ailSearch[i] = 0;
+
+	this->aubReach.clear();
+	this->aiReachCells.clear();
+
+} // construct
+
+
+WormAISearch::~WormAISearch() {
+
+	this->aubReach.clear();
+	this->aiReachCells.clear();
+
+} // dealloc
+
+
+void WormAISearch::move(Worm *pWorm) {
+
+	if (pWorm != this->pWormPlanned) {
+
+		this->onDebugMessage("move() without plan()");
+		return;
+
+	} // if nothing planned for this worm
+
+	this->pWormPlanned = nullptr;
+
+	const int iCurrent = WormAI::headingIndex(pWorm->currentDirection());
+	bool bWanderBest = false;
+	int iBest = -1;
+	qint32 ilBestYet = 0;
+	qint32 ilScore;
+	int i;
+
+	// ahead, left, right
+	for (int k = 0; k < 3; ++k) {
+
+		i = (0 == k) ? iCurrent : (iCurrent + ((1 == k) ? 1 : 3)) & 3;
+		ilScore = this->ailScores[i] + this->ailSearch[i];
+
+		// a bonus that way breaks ties, else the order of trying does
+		if ((0 > iBest) || (ilScore < ilBestYet)
+				|| ((ilScore == ilBestYet) && this->abWander[i] && !bWanderBest)) {
+
+			iBest = i;
+			ilBestYet = ilScore;
+			bWanderBest = this->abWander[i];
+
+		} // if better
+
+	} // loop headings
+
+	pWorm->setHeading(L::Heading(L::North + iBest));
+
+} // move
+
+
+void WormAISearch::plan(Worm *pWorm, const QVector<Worm *> apWorms, const MapGame *pMap) {
+
+	WormAI::plan(pWorm, apWorms, pMap);
+
+	this->iDepthDone = 0;
+	for (int k = 0; k < 4; ++k) this->ailSearch[k] = 0;
+
+	if (nullptr == this->pWormPlanned) return;
+	if (EffortReflex <= this->eEffort) return;
+
+	const QPoint oHead = pWorm->headPoint();
+	if (!pMap->contains(quint8(oHead.x()), quint8(oHead.y()))) return;
+
+	static const quint16 uiCapacity = SssS_Nibblers_Surface_Height * SssS_Nibblers_Surface_Width;
+	const int iHead = pMap->cellIndex(oHead);
+	const int iCurrent = WormAI::headingIndex(pWorm->currentDirection());
+	qint32 ailFound[4];
+	L::Heading eDirection;
+	int iCell, iDepth, i, k;
+
+	this->bOutOfTime = false;
+	this->ulNodes = 0u;
+	this->ilNeed = qMax(qint32(SssS_Nibblers_Surface_Width), qint32(pWorm->length()));
+
+	this->reach(apWorms, pWorm);
+	this->oSearchFree.assign(pMap->freeCells());
+
+	for (iDepth = 1; iDepth <= SssS_Nibblers_AI_Search_Depth; ++iDepth) {
+
+		for (k = 0; k < 4; ++k) ailFound[k] = 0;
+
+		// ahead, left, right
+		for (k = 0; k < 3; ++k) {
+
+			i = (0 == k) ? iCurrent : (iCurrent + ((1 == k) ? 1 : 3)) & 3;
+			eDirection = L::Heading(L::North + i);
+			iCell = pMap->neighbour(iHead, eDirection);
+
+			if (this->isOpen(iCell, 1))
+				ailFound[i] = this->search(iCell, eDirection, 1, iDepth);
+			else ailFound[i] = uiCapacity + iDepth;
+
+			if (this->bOutOfTime) break;
+
+		} // loop headings
+
+		// unfinished searches don't count
+		if (this->bOutOfTime) break;
+
+		for (k = 0; k < 4; ++k) this->ailSearch[k] = ailFound[k];
+		this->iDepthDone = iDepth;
+
+	} // loop deepening
+
+} // plan
+
+
+// breadth first from the heads of other living worms
+void WormAISearch::reach(const QVector<Worm *> apWorms, Worm *pWorm) {
+
+	const Bitboard &oFree = this->pMapGame->freeCells();
+	quint8 *pubReach;
+	quint8 ubSteps;
+	QPoint oHead;
+	Worm *pWormOther;
+	int iCell, iNext;
+	int i, k;
+
+	this->aubReach.fill(0xFFu, this->pMapGame->cellCount());
+	this->aiReachCells.resize(0);
+	pubReach = this->aubReach.data();
+
+	for (i = 0; i < apWorms.length(); ++i) {
+
+		pWormOther = apWorms.at(i);
+		if (pWormOther == pWorm) continue;
+		if (pWormOther->isDead()) continue;
+
+		oHead = pWormOther->headPoint();
+		if (!this->pMapGame->contains(quint8(oHead.x()), quint8(oHead.y()))) continue;
+
+		iCell = this->pMapGame->cellIndex(oHead);
+		for (k = 0; k < 4; ++k) {
+
+			iNext = this->pMapGame->neighbour(iCell, L::Heading(L::North + k));
+			if (!oFree.at(iNext) || (1u == pubReach[iNext])) continue;
+
+			pubReach[iNext] = 1u;
+			this->aiReachCells.append(iNext);
+
+		} // loop neighbours
+
+	} // loop worms
+
+	// grows while being walked
+	for (i = 0; i < this->aiReachCells.length(); ++i) {
+
+		iCell = this->aiReachCells.at(i);
+		ubSteps = pubReach[iCell];
+		if (SssS_Nibblers_AI_Search_Depth <= ubSteps) continue;
+
+		for (k = 0; k < 4; ++k) {
+
+			iNext = this->pMapGame->neighbour(iCell, L::Heading(L::North + k));
+			if (!oFree.at(iNext) || (0xFFu != pubReach[iNext])) continue;
+
+			pubReach[iNext] = ubSteps + 1u;
+			this->aiReachCells.append(iNext);
+
+		} // loop neighbours
+
+	} // loop cells reached
+
+} // reach
+
+
+qint32 WormAISearch::room(const int iCell, const int iPly) {
+
+	int iOther;
+
+	this->oSearchPassable.assign(this->oSearchFree);
+	this->oSearchPassable.setAt(iCell, false);
+
+	// what other worms may have taken by now
+	for (int i = 0; i < this->aiReachCells.length(); ++i) {
+
+		iOther = this->aiReachCells.at(i);
+		if (iPly < this->aubReach.at(iOther)) break;
+
+		this->oSearchPassable.setAt(iOther, false);
+
+	} // loop cells in reach
+
+	const int iCount = this->oSearchReached.flood(this->oSearchPassable, iCell, this->ilNeed);
+
+	return (iCount >= this->ilNeed) ? 0 : this->ilNeed - iCount;
+
+} // room
+
+
+qint32 WormAISearch::search(const int iCell, const L::Heading eHeading,
+							const int iPly, const int iDepth) {
+
+	// looking at the clock costs, so not every time
+	if ((0u == (++this->ulNodes & 63u)) && (nullptr != this->pClock)
+			&& (this->illDeadline <= this->pClock->nsecsElapsed()))
+		this->bOutOfTime = true;
+
+	if (this->bOutOfTime) return 0;
+
+	if (iPly >= iDepth) return this->room(iCell, iPly);
+
+	static const quint16 uiCapacity = SssS_Nibblers_Surface_Height * SssS_Nibblers_Surface_Width;
+	const int iHeading = WormAI::headingIndex(eHeading);
+	// trapped, the sooner the worse
+	qint32 ilBest = uiCapacity + iDepth - iPly;
+	qint32 ilFound;
+	L::Heading eNext;
+	int iNext;
+
+	this->oSearchFree.setAt(iCell, false);
+
+	// ahead, left, right
+	for (int k = 0; k < 3; ++k) {
+
+		eNext = L::Heading(L::North
+						   + ((0 == k) ? iHeading : (iHeading + ((1 == k) ? 1 : 3)) & 3));
+		iNext = this->pMapGame->neighbour(iCell, eNext);
+
+		if (!this->isOpen(iNext, iPly + 1)) continue;
+
+		ilFound = this->search(iNext, eNext, iPly + 1, iDepth);
+		if (ilFound < ilBest) ilBest = ilFound;
+
+		// can't get any better than not trapped
+		if (0 >= ilBest) break;
+
+	} // loop headings
+
+	this->oSearchFree.setAt(iCell, true);
+
+	return ilBest;
+
+} // search
+
+
+
+}	} // namespace SwissalpS::QtNibblers
@@ -0,0 +1,103 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WORMAISEARCH_H
+#define WORMAISEARCH_H
+
+#include <QElapsedTimer>
+#include <QVector>
+#include "Bitboard.h"
+#include "definitions.h"
+#include "WormAI.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// AI that looks up to SssS_Nibblers_AI_Search_Depth moves ahead instead
+// of one. Tries ahead, left and right at every step, deepening one move
+// at a time until the deadline given to setDeadline() passes. Results of
+// the deepest finished search are added to the scores WormAI::plan()
+// found. Other worms are not searched, every cell they could have reached
+// by a move counts as taken from then on. Tails are assumed to stay put.
+// Draws no random numbers, but as it depends on timing, its headings are
+// recorded in replays.
+class WormAISearch : public SwissalpS::QtNibblers::WormAI {
+
+	Q_OBJECT
+
+private:
+
+protected:
+	bool bOutOfTime;
+	// deepest search that finished this plan
+	int iDepthDone;
+	// cells search() needs free around the last cell to not count as trapped
+	qint32 ilNeed;
+	qint64 illDeadline;
+	quint32 ulNodes;
+	// per heading index, result of search() in the deepest finished search
+	qint32 ailSearch[4];
+	// per cell, moves another worm needs to get there, 0xFF if more
+	// than SssS_Nibblers_AI_Search_Depth
+	QVector<quint8> aubReach;
+	// cells in order of aubReach, filled by reach() and read by room()
+	QVector<int> aiReachCells;
+	// free cells minus the ones the path being tried takes
+	Bitboard oSearchFree;
+	// what room() floods
+	Bitboard oSearchPassable;
+	Bitboard oSearchReached;
+	const QElapsedTimer *pClock;
+
+	// can the worm be on iCell after iPly moves
+	inline bool isOpen(const int iCell, const int iPly) const {
+		return this->oSearchFree.at(iCell) && (iPly < this->aubReach.at(iCell)); }
+
+	virtual void reach(const QVector<Worm *>apWorms, Worm *pWorm);
+	// like WormAI::deadend() for the worm on iCell after iPly moves
+	virtual qint32 room(const int iCell, const int iPly);
+	// best score the worm on iCell heading eHeading after iPly moves can
+	// still get within iDepth moves, 0 if it is not trapped
+	virtual qint32 search(const int iCell, const L::Heading eHeading,
+						  const int iPly, const int iDepth);
+
+public:
+	explicit WormAISearch(Random *pRandom, QObject *pParent = nullptr);
+	virtual ~WormAISearch() override;
+
+	inline virtual int depth() const { return this->iDepthDone; }
+	inline virtual bool isRecorded() const override { return true; }
+	// turns pWorm to the best heading plan() found, prefers ones leading
+	// to a bonus, then ahead, left and right
+	virtual void move(Worm *pWorm) override;
+	virtual void plan(Worm *pWorm, const QVector<Worm *>apWorms, const MapGame *pMap) override;
+	inline virtual void setDeadline(const QElapsedTimer *pClock,
+									const qint64 illDeadline) override {
+		this->pClock = pClock; this->illDeadline = illDeadline; }
+
+}; // WormAISearch
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // WORMAISEARCH_H
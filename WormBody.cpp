@@ -0,0 +1,279 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "WormBody.h"
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+WormBody::WormBody() :
+	bReversed(false),
+	uiHead(0u),
+	uiTail(0u),
+	iCount(0),
+	iStart(0) {
+
+	this->aubLinks.fill(0u, 4);
+
+} // construct
+
+
+quint16 WormBody::across(const quint16 uiCell, const int iLink, const bool bTowardTail) const {
+
+	const int iSlot = this->linkSlot(iLink);
+
+	// the head side is the front unless reversed
+	const bool bFromFront = (bTowardTail != this->bReversed);
+
+	if (!this->hulHops.isEmpty() && this->hulHops.contains(iSlot)) {
+
+		const quint32 ulHop = this->hulHops.value(iSlot);
+
+		return quint16(bFromFront ? (ulHop & 0xFFFFu) : (ulHop >> 16));
+
+	} // if hop
+
+	int iHeading = (this->aubLinks.at(iSlot >> 2) >> ((iSlot & 3) << 1)) & 3;
+
+	// links lead from back to front
+	if (bFromFront) iHeading ^= 2;
+
+	return quint16(this->aiNeighbours.at((int(uiCell) << 2) + iHeading));
+
+} // across
+
+
+void WormBody::append(const quint16 uiCell) {
+
+	if (0 == this->iCount) {
+
+		this->uiHead = this->uiTail = uiCell;
+		this->iCount = 1;
+
+		return;
+
+	} // if first cell
+
+	if ((this->aubLinks.length() << 2) == this->linkCount()) this->grow();
+
+	const int iMask = (this->aubLinks.length() << 2) - 1;
+
+	if (this->bReversed) {
+
+		this->iStart = (this->iStart - 1) & iMask;
+		this->setLink(this->iStart, uiCell, this->uiTail);
+
+	} else this->setLink((this->iStart + this->linkCount()) & iMask, this->uiTail, uiCell);
+
+	this->uiTail = uiCell;
+	this->iCount++;
+
+} // append
+
+
+quint16 WormBody::at(const int iIndex) const {
+
+	quint16 uiCell;
+	int iLink;
+
+	// walk from whichever end is nearer
+	if (iIndex <= this->iCount - 1 - iIndex) {
+
+		uiCell = this->uiHead;
+		for (iLink = 0; iLink < iIndex; ++iLink)
+			uiCell = this->across(uiCell, iLink, true);
+
+	} else {
+
+		uiCell = this->uiTail;
+		for (iLink = this->linkCount() - 1; iLink >= iIndex; --iLink)
+			uiCell = this->across(uiCell, iLink, false);
+
+	} // if nearer head
+
+	return uiCell;
+
+} // at
+
+
+void WormBody::clear() {
+
+	this->bReversed = false;
+	this->iCount = 0;
+	this->iStart = 0;
+	this->hulHops.clear();
+
+} // clear
+
+
+void WormBody::grow() {
+
+	const int iMask = (this->aubLinks.length() << 2) - 1;
+	const int iLinks = this->linkCount();
+	const QVector<quint8> aubOld(this->aubLinks);
+	const QHash<int, quint32> hulOld(this->hulHops);
+	int iSlot;
+
+	// same order, starting at slot 0
+	this->aubLinks.fill(0u, aubOld.length() * 2);
+	this->hulHops.clear();
+	for (int i = 0; i < iLinks; ++i) {
+
+		iSlot = (this->iStart + i) & iMask;
+
+		this->aubLinks[i >> 2] = this->aubLinks.at(i >> 2)
+				| quint8(((aubOld.at(iSlot >> 2) >> ((iSlot & 3) << 1)) & 3) << ((i & 3) << 1));
+
+		if (hulOld.contains(iSlot)) this->hulHops.insert(i, hulOld.value(iSlot));
+
+	} // loop links
+
+	this->iStart = 0;
+
+} // grow
+
+
+void WormBody::prepend(const quint16 uiCell) {
+
+	if (0 == this->iCount) {
+
+		this->uiHead = this->uiTail = uiCell;
+		this->iCount = 1;
+
+		return;
+
+	} // if first cell
+
+	if ((this->aubLinks.length() << 2) == this->linkCount()) this->grow();
+
+	const int iMask = (this->aubLinks.length() << 2) - 1;
+
+	if (this->bReversed) {
+
+		this->setLink((this->iStart + this->linkCount()) & iMask, this->uiHead, uiCell);
+
+	} else {
+
+		this->iStart = (this->iStart - 1) & iMask;
+		this->setLink(this->iStart, uiCell, this->uiHead);
+
+	} // if head is at end of ring
+
+	this->uiHead = uiCell;
+	this->iCount++;
+
+} // prepend
+
+
+void WormBody::reverse() {
+
+	const quint16 uiHead = this->uiHead;
+
+	this->uiHead = this->uiTail;
+	this->uiTail = uiHead;
+	this->bReversed = !this->bReversed;
+
+} // reverse
+
+
+void WormBody::setLink(const int iSlot, const quint16 uiFront, const quint16 uiBack) {
+
+	const int iShift = (iSlot & 3) << 1;
+	int iHeading;
+
+	if (!this->hulHops.isEmpty()) this->hulHops.remove(iSlot);
+
+	for (iHeading = 0; iHeading < 4; ++iHeading)
+		if (uiFront == this->aiNeighbours.at((int(uiBack) << 2) + iHeading)) break;
+
+	if (4 == iHeading) {
+
+		this->hulHops.insert(iSlot, (quint32(uiFront) << 16) | uiBack);
+		iHeading = 0;
+
+	} // if no step to a neighbour
+
+	this->aubLinks[iSlot >> 2] = quint8((this->aubLinks.at(iSlot >> 2) & ~(3 << iShift))
+										| (iHeading << iShift));
+
+} // setLink
+
+
+void WormBody::setNeighbours(const QVector<int> aiNeighbours) {
+
+	this->aiNeighbours = aiNeighbours;
+	this->clear();
+
+} // setNeighbours
+
+
+quint16 WormBody::takeLast() {
+
+	const quint16 uiCell = this->uiTail;
+
+	if (1 >= this->iCount) {
+
+		this->clear();
+
+		return uiCell;
+
+	} // if last one
+
+	const int iLink = this->linkCount() - 1;
+	const int iSlot = this->linkSlot(iLink);
+
+	this->uiTail = this->across(uiCell, iLink, false);
+
+	if (!this->hulHops.isEmpty()) this->hulHops.remove(iSlot);
+
+	// tail end of ring is where iStart is when reversed
+	if (this->bReversed)
+		this->iStart = (this->iStart + 1) & ((this->aubLinks.length() << 2) - 1);
+
+	this->iCount--;
+
+	return uiCell;
+
+} // takeLast
+
+
+QVector<quint16> WormBody::toVector() const {
+
+	QVector<quint16> auiCells;
+	auiCells.reserve(this->iCount);
+
+	if (0 == this->iCount) return auiCells;
+
+	quint16 uiCell = this->uiHead;
+	auiCells.append(uiCell);
+	for (int iLink = 0; iLink < this->linkCount(); ++iLink) {
+
+		uiCell = this->across(uiCell, iLink, true);
+		auiCells.append(uiCell);
+
+	} // loop links
+
+	return auiCells;
+
+} // toVector
+
+
+
+}	} // namespace SwissalpS::QtNibblers
@@ -0,0 +1,102 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WORMBODY_H
+#define WORMBODY_H
+
+#include <QHash>
+#include <QVector>
+#include <QtGlobal>
+
+
+
+namespace SwissalpS { namespace QtNibblers {
+
+
+
+// Cells of a worm as head and tail cell index plus, for each link between
+// two segments, the heading from one to the other in 2 bits of a ring that
+// doubles when full. Links that are no step to a neighbour, like through a
+// teleporter, are kept aside as hops. Reversing only swaps the ends.
+// Cells in the middle are found by walking from the nearer end, so loop
+// over toVector() rather than at().
+class WormBody {
+
+private:
+
+protected:
+	// links are read from the other end
+	bool bReversed;
+	quint16 uiHead;
+	quint16 uiTail;
+	int iCount;
+	// slot of first link, which is next to the head when not reversed
+	int iStart;
+	// 4 links per byte, size a power of 2. A link holds the heading index
+	// that leads from its cell farther from iStart's end of the ring to the
+	// nearer one
+	QVector<quint8> aubLinks;
+	// per slot of a hop its cells, the one nearer iStart's end in upper bits
+	QHash<int, quint32> hulHops;
+	// see Map::neighbourTable()
+	QVector<int> aiNeighbours;
+
+	// cell on the other side of link iLink, which joins segments iLink and
+	// iLink + 1, from uiCell on the head side if bTowardTail
+	quint16 across(const quint16 uiCell, const int iLink, const bool bTowardTail) const;
+	void grow();
+	inline int linkCount() const { return qMax(0, this->iCount - 1); }
+	inline int linkSlot(const int iLink) const {
+		return (this->bReversed ? this->iStart + this->linkCount() - 1 - iLink
+								: this->iStart + iLink) & ((this->aubLinks.length() << 2) - 1); }
+
+	// link at iSlot records the step from uiBack to uiFront, which is
+	// nearer iStart's end
+	void setLink(const int iSlot, const quint16 uiFront, const quint16 uiBack);
+
+public:
+	explicit WormBody();
+
+	// adds a new tail
+	void append(const quint16 uiCell);
+	// iIndex counts from the head
+	quint16 at(const int iIndex) const;
+	void clear();
+	inline quint16 first() const { return this->uiHead; }
+	inline bool isEmpty() const { return 0 == this->iCount; }
+	inline quint16 last() const { return this->uiTail; }
+	inline int length() const { return this->iCount; }
+	// adds a new head
+	void prepend(const quint16 uiCell);
+	// tail becomes head
+	void reverse();
+	// of the map cells are on, clears the body
+	void setNeighbours(const QVector<int> aiNeighbours);
+	// removes the tail and returns it
+	quint16 takeLast();
+	// all cells, head first
+	QVector<quint16> toVector() const;
+
+}; // WormBody
+
+
+
+}	} // namespace SwissalpS::QtNibblers
+
+
+
+#endif // WORMBODY_H
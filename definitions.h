@@ -18,6 +18,9 @@
 #ifndef DEFINITIONS_H
 #define DEFINITIONS_H
 
+#define SssS_Nibblers_AI_Near quint8(3u)
+#define SssS_Nibblers_AI_Search_Depth quint8(8u)
+
 #define SssS_Nibblers_App_Domain_QString QStringLiteral("ws.swissalps.qtssssnibblers")
 #define SssS_Nibblers_App_Name_QString QStringLiteral("QtSssSNibblers")
 #define SssS_Nibblers_App_Org_QString QStringLiteral("SwissalpS")
@@ -48,6 +51,9 @@
 #define SssS_Nibblers_Bonus_Penalty_Miss quint8(1u)
 #define SssS_Nibblers_Bonus_Max_Missed quint8(2u)
 
+// slots of the wheel bonuses time out on, a power of 2 above most lifetimes
+#define SssS_Nibblers_Bonus_Wheel_Slots quint32(512u)
+
 #define SssS_Nibblers_Colour_0 Qt::blue
 #define SssS_Nibblers_Colour_1 Qt::cyan
 #define SssS_Nibblers_Colour_2 Qt::darkCyan
@@ -80,4 +86,12 @@
 #define SssS_Nibblers_Surface_Minimum_Cell_Side quint8(7u)
 #define SssS_Nibblers_Surface_Width quint8(92u)
 
+// 0 traces nothing, 1 the phases of each tick, 2 also single worms and cells.
+// Set with DEFINES += SssS_Nibblers_Trace_Level=1 in the .pro file
+#ifndef SssS_Nibblers_Trace_Level
+#define SssS_Nibblers_Trace_Level 0
+#endif
+// per thread, a power of 2
+#define SssS_Nibblers_Trace_Records quint32(16384u)
+
 #endif // DEFINITIONS_H
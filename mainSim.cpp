@@ -0,0 +1,362 @@
+/*
+ * QtSssSNibblers: SwissalpS Nibbles written with Qt-Framework
+ * Copyright (C) 2018-2019 Luke J. Zimmermann aka SwissalpS <SwissalpS@LukeZimmermann.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// nibblers-sim: plays AI-only games without surface, sound or timers
+// on all cores and prints one JSON line per game to stdout followed by
+// a summary line
+#include "AppSettings.h"
+#include "definitions.h"
+#include "GameHeadless.h"
+#include "Replay.h"
+#include "Tournament.h"
+#include "Trace.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+
+using namespace SwissalpS::QtNibblers;
+
+// "1,3,5-7" -> 1 3 5 6 7, values outside ubMin..ubMax are dropped
+static QVector<quint8> parseList(const QString sList, const quint8 ubMin,
+								 const quint8 ubMax) {
+
+	QVector<quint8> aubOut;
+	QStringList asRange;
+	QStringList asParts = sList.split(",", QString::SkipEmptyParts);
+	uint uiFirst;
+	uint uiLast;
+	for (int i = 0; i < asParts.length(); ++i) {
+
+		asRange = asParts.at(i).split("-");
+		uiFirst = asRange.first().trimmed().toUInt();
+		uiLast = asRange.last().trimmed().toUInt();
+
+		for (uint uiValue = uiFirst; uiValue <= uiLast; ++uiValue) {
+
+			if ((ubMin > uiValue) || (ubMax < uiValue)) continue;
+
+			aubOut.append(quint8(uiValue));
+
+		} // loop range
+
+	} // loop parts
+
+	return aubOut;
+
+} // parseList
+
+
+// plays back a recorded game and prints the outcome, or the standings
+// at tick illSeek unless it is negative
+static int playReplay(const QString sFile, const QString sPathLevels,
+					  const qint64 illSeek, QTextStream &oOut, QTextStream &oErr) {
+
+	QFile oFile(sFile);
+	if (!oFile.open(QIODevice::ReadOnly)) {
+
+		oErr << "Can not open " << sFile << "\n";
+
+		return 1;
+
+	} // if can not open
+
+	Replay oReplay;
+	if (!oReplay.load(&oFile)) {
+
+		oErr << sFile << " is not a replay\n";
+
+		return 1;
+
+	} // if invalid
+
+	GameHeadless oGame;
+	oGame.setLevelPath(sPathLevels);
+
+	// the keys Game reads that the replay does not hold, so the player's
+	// Settings.ini has no say. Searching AI headings are recorded, so its
+	// budget does not matter
+	oGame.setSetting(AppSettings::sSettingGameAIBudget, 0u);
+	oGame.setSetting(AppSettings::sSettingGameParallelAI, false);
+
+	bool bPlayed;
+	if (0 > illSeek) bPlayed = oGame.playReplay(&oReplay);
+	else bPlayed = oGame.openReplay(&oReplay) && oGame.seekReplay(quint32(illSeek));
+
+	QJsonArray aWorms;
+	QVector<HistoryItem *> apResults = oGame.results();
+	for (int i = 0; i < apResults.length(); ++i)
+		aWorms.append(apResults.at(i)->toJSON());
+
+	// game not over yet, no ranking
+	QJsonObject oWorm;
+	QVector<Worm *> apWorms = oGame.worms();
+	for (int i = 0; apResults.isEmpty() && (i < apWorms.length()); ++i) {
+
+		oWorm = QJsonObject();
+		oWorm.insert("name", apWorms.at(i)->name());
+		oWorm.insert("levelsDone", apWorms.at(i)->levelCount());
+		oWorm.insert("livesLost", apWorms.at(i)->livesLost());
+		oWorm.insert("score", qint64(apWorms.at(i)->score()));
+		aWorms.append(oWorm);
+
+	} // loop worms
+
+	QJsonObject oResult;
+	oResult.insert("replay", sFile);
+	oResult.insert("keyframes", oReplay.keyframeCount());
+	oResult.insert("level", oReplay.level());
+	oResult.insert("ticks", qint64(oGame.ticks()));
+	oResult.insert("over", oGame.isDone());
+	oResult.insert("won", oGame.isWon());
+	oResult.insert("diverged", oGame.isDiverged());
+	oResult.insert("aborted", oGame.isAborted());
+	oResult.insert("worms", aWorms);
+
+	oOut << QJsonDocument(oResult).toJson(QJsonDocument::Compact) << "\n";
+	oOut.flush();
+
+	if (!bPlayed) return 2;
+
+	return oGame.isDiverged() ? 3 : 0;
+
+} // playReplay
+
+
+// dumps what Trace recorded, if asked to and built with tracing
+static void writeTrace(const QString sFile, QTextStream &oErr) {
+
+	if (sFile.isEmpty()) return;
+
+	if (0 == SssS_Nibblers_Trace_Level)
+		oErr << "Built without tracing, see SssS_Nibblers_Trace_Level\n";
+
+	if (!Trace::writeChromeTrace(sFile)) oErr << "Can not write " << sFile << "\n";
+
+} // writeTrace
+
+
+int main(int iArgCount, char *aArguments[]) {
+
+	QCoreApplication oApp(iArgCount, aArguments);
+
+	QCommandLineParser oParser;
+	oParser.setApplicationDescription(
+				"Plays AI-only games of SwissalpS Nibblers as fast as possible.\n"
+				"Every combination of level and AI count is played once per seed.");
+	oParser.addHelpOption();
+
+	QCommandLineOption oOptionAIs(QStringList() << "a" << "ais",
+								  "Number of AI worms (1-8), list or range"
+								  " e.g. 2,4-8.", "counts", "4");
+	QCommandLineOption oOptionAIBudget("ai-budget",
+									   "Microseconds searching AI may use per tick,"
+									   " 0 searches to full depth every time.",
+									   "microseconds", "0");
+	QCommandLineOption oOptionBadLevelMode("bad-level-mode",
+										   "What to do on unplayable levels (0-2).",
+										   "mode", "0");
+	QCommandLineOption oOptionFakes("fakes", "Use fake bonuses.");
+	QCommandLineOption oOptionGames(QStringList() << "g" << "games",
+									"Number of seeds per level and AI count.",
+									"count", "1");
+	QCommandLineOption oOptionLastDead("last-dead",
+									   "Game is over when last worm is dead"
+									   " instead of first.");
+	QCommandLineOption oOptionLevel(QStringList() << "l" << "level",
+									"Level to start on, list or range"
+									" e.g. 1,3,10-12.", "levels", "1");
+	QCommandLineOption oOptionLevels("levels",
+									 "Directory containing Level_N files.", "path");
+	QCommandLineOption oOptionLookahead("lookahead",
+										"AI worms that search ahead instead of"
+										" playing like GNOME-Nibbles, list or"
+										" range e.g. 1,3.", "ais");
+	QCommandLineOption oOptionLives("lives", "Lives per worm.", "count",
+									QString::number(AppSettings::ubSettingGameStartLivesDefault));
+	QCommandLineOption oOptionReplay("replay", "Play back a recorded game instead"
+											   " and print its outcome.", "file");
+	QCommandLineOption oOptionSeek("seek", "With --replay: stop at this tick and"
+										   " print standings there.", "tick");
+	QCommandLineOption oOptionSeed("seed", "Seed of first game, the others count up"
+										   " from there. Default: from clock.", "seed");
+	QCommandLineOption oOptionTicksMax("max-ticks",
+									   "Declare game stalled after this many ticks"
+									   " (0 for no limit).", "ticks", "250000");
+	QCommandLineOption oOptionSpeed(QStringList() << "s" << "speed",
+									"Speed index (0-4), sets tick to bonus-tick ratio.",
+									"index", "3");
+	QCommandLineOption oOptionThreads(QStringList() << "t" << "threads",
+									  "Number of threads.", "count",
+									  QString::number(QThread::idealThreadCount()));
+	QCommandLineOption oOptionTrace("trace", "Write Chrome trace JSON of the last"
+											 " ticks of each thread to file.", "file");
+	QCommandLineOption oOptionUnlimitedLives("unlimited-lives",
+											 "Do not cap lives gained from hearts.");
+
+	oParser.addOption(oOptionAIs);
+	oParser.addOption(oOptionAIBudget);
+	oParser.addOption(oOptionBadLevelMode);
+	oParser.addOption(oOptionFakes);
+	oParser.addOption(oOptionGames);
+	oParser.addOption(oOptionLastDead);
+	oParser.addOption(oOptionLevel);
+	oParser.addOption(oOptionLevels);
+	oParser.addOption(oOptionLives);
+	oParser.addOption(oOptionLookahead);
+	oParser.addOption(oOptionReplay);
+	oParser.addOption(oOptionSeed);
+	oParser.addOption(oOptionSeek);
+	oParser.addOption(oOptionTicksMax);
+	oParser.addOption(oOptionSpeed);
+	oParser.addOption(oOptionThreads);
+	oParser.addOption(oOptionTrace);
+	oParser.addOption(oOptionUnlimitedLives);
+
+	oParser.process(oApp);
+
+	QTextStream oOut(stdout);
+	QTextStream oErr(stderr);
+
+	QVector<quint8> aubAIs = parseList(oParser.value(oOptionAIs), 1u,
+									   SssS_Nibblers_Max_Players);
+	QVector<quint8> aubLevels = parseList(oParser.value(oOptionLevel), 1u, 0xFFu);
+	QVector<quint8> aubLookahead = parseList(oParser.value(oOptionLookahead), 1u,
+											 SssS_Nibblers_Max_Players);
+	quint8 ubLookahead = 0u;
+	for (int i = 0; i < aubLookahead.length(); ++i)
+		ubLookahead |= quint8(1u << (aubLookahead.at(i) - 1u));
+
+	quint32 ulGames = oParser.value(oOptionGames).toUInt();
+	quint32 ulSeed = oParser.isSet(oOptionSeed)
+					 ? oParser.value(oOptionSeed).toUInt()
+					 : quint32(QDateTime::currentMSecsSinceEpoch());
+
+	if (aubAIs.isEmpty() || aubLevels.isEmpty()) {
+
+		oErr << "Nothing to play, check --ais and --level\n";
+
+		return 1;
+
+	} // if nothing to do
+
+	// games still hold a pointer to the singleton, so create it here
+	AppSettings *pAS = AppSettings::pAppSettings();
+
+	// resolve the level path here so workers never touch AppSettings
+	QString sPathLevels;
+	if (oParser.isSet(oOptionLevels)) {
+
+		sPathLevels = oParser.value(oOptionLevels);
+		if (!sPathLevels.endsWith("/")) sPathLevels += "/";
+
+	} else {
+
+		// copies levels from resources if needed
+		pAS->getDataPathLevelFile(aubLevels.first());
+		sPathLevels = pAS->getDataPath();
+
+	} // if own level path
+
+	if (oParser.isSet(oOptionReplay)) {
+
+		qint64 illSeek = oParser.isSet(oOptionSeek)
+						 ? qint64(oParser.value(oOptionSeek).toUInt()) : -1;
+
+		int iExit = playReplay(oParser.value(oOptionReplay), sPathLevels, illSeek,
+							   oOut, oErr);
+		writeTrace(oParser.value(oOptionTrace), oErr);
+		AppSettings::drop();
+
+		return iExit;
+
+	} // if replay
+
+	Tournament *pTournament = new Tournament();
+	pTournament->setLevelPath(sPathLevels);
+
+	pTournament->setSetting(AppSettings::sSettingGameAIBudget,
+							oParser.value(oOptionAIBudget).toUInt());
+	pTournament->setSetting(AppSettings::sSettingGameAILookahead, uint(ubLookahead));
+	pTournament->setSetting(AppSettings::sSettingGameBadLevelMode,
+							oParser.value(oOptionBadLevelMode).toUInt());
+	pTournament->setSetting(AppSettings::sSettingGameFakeBonuses,
+							oParser.isSet(oOptionFakes));
+	pTournament->setSetting(AppSettings::sSettingGameLimitLives,
+							oParser.isSet(oOptionUnlimitedLives));
+	pTournament->setSetting(AppSettings::sSettingGameOverOnLastDead,
+							oParser.isSet(oOptionLastDead));
+	pTournament->setSetting(AppSettings::sSettingGameSpeed,
+							oParser.value(oOptionSpeed).toInt());
+	pTournament->setSetting(AppSettings::sSettingGameStartLevel,
+							uint(aubLevels.first()));
+	pTournament->setSetting(AppSettings::sSettingGameStartLives,
+							oParser.value(oOptionLives).toUInt());
+	pTournament->setThreads(oParser.value(oOptionThreads).toInt());
+	pTournament->setTicksMax(oParser.value(oOptionTicksMax).toUInt());
+
+	for (int iLevel = 0; iLevel < aubLevels.length(); ++iLevel) {
+		for (int iAIs = 0; iAIs < aubAIs.length(); ++iAIs) {
+			for (quint32 ulGame = 0u; ulGame < ulGames; ++ulGame) {
+
+				pTournament->addMatch(aubLevels.at(iLevel), aubAIs.at(iAIs),
+									  ulSeed + ulGame);
+
+			} // loop seeds
+		} // loop AI counts
+	} // loop levels
+
+	int iExit = pTournament->run() ? 0 : 2;
+
+	QJsonObject oResult;
+	for (int iMatch = 0; iMatch < pTournament->matchCount(); ++iMatch) {
+
+		oResult = pTournament->result(iMatch);
+
+		if (oResult.value("aborted").toBool())
+			oErr << "Level " << oResult.value("level").toInt()
+				 << " can not be played with " << oResult.value("ais").toInt()
+				 << " worms\n";
+
+		oOut << QJsonDocument(oResult).toJson(QJsonDocument::Compact) << "\n";
+
+	} // loop matches
+
+	QJsonObject oSummary = pTournament->summary();
+	QJsonObject oLine;
+	oLine.insert("summary", oSummary);
+	oOut << QJsonDocument(oLine).toJson(QJsonDocument::Compact) << "\n";
+	oOut.flush();
+
+	oErr << pTournament->matchCount() << " games on "
+		 << pTournament->threads() << " threads in "
+		 << pTournament->elapsed() << " ms ("
+		 << oSummary.value("gamesPerSecond").toDouble() << " games/s)\n";
+
+	delete pTournament;
+	writeTrace(oParser.value(oOptionTrace), oErr);
+	AppSettings::drop();
+
+	return iExit;
+
+} // main
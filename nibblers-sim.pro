@@ -0,0 +1,63 @@
+#-------------------------------------------------
+#
+# nibblers-sim: plays AI-only games without surface, sound or timers.
+# Run with --help for options.
+#
+#-------------------------------------------------
+
+QT		+= core gui
+QT		-= widgets
+
+CONFIG	+= console
+CONFIG	-= app_bundle
+
+TARGET = nibblers-sim
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+
+SOURCES += \
+	AppSettings.cpp \
+	Bitboard.cpp \
+	Bonus.cpp \
+	Fx.cpp \
+	Game.cpp \
+	GameHeadless.cpp \
+	HistoryItem.cpp \
+	IconEngine.cpp \
+	mainSim.cpp \
+	Map.cpp \
+	MapGame.cpp \
+	Random.cpp \
+	Replay.cpp \
+	Tournament.cpp \
+	Trace.cpp \
+	Worm.cpp \
+	WormAI.cpp \
+	WormAISearch.cpp \
+	WormBody.cpp
+
+HEADERS += \
+	AppSettings.h \
+	Bitboard.h \
+	Bonus.h \
+	definitions.h \
+	Fx.h \
+	Game.h \
+	GameHeadless.h \
+	HistoryItem.h \
+	IconEngine.h \
+	Lingo.h \
+	Map.h \
+	MapGame.h \
+	Random.h \
+	Replay.h \
+	Tournament.h \
+	Trace.h \
+	Worm.h \
+	WormAI.h \
+	WormAISearch.h \
+	WormBody.h
+
+RESOURCES += QtSssSNibblers.qrc